@@ -0,0 +1,70 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../game/batch/game_batch.h"
+
+using namespace std;
+
+// Steps a batch of games with random keys, the way a training loop would, and reports the throughput
+int main(int argc, char** argv){
+	int games = 64, tanks = 2, threads = thread::hardware_concurrency(), steps = 2000;
+	unsigned int seed = 1;
+	for(int i = 1; i + 1 < argc; i += 2){
+		string option = argv[i];
+		if(option == "--games") games = atoi(argv[i + 1]);
+		if(option == "--tanks") tanks = atoi(argv[i + 1]);
+		if(option == "--threads") threads = atoi(argv[i + 1]);
+		if(option == "--steps") steps = atoi(argv[i + 1]);
+		if(option == "--seed") seed = atoi(argv[i + 1]);
+	}
+	if(threads < 1) threads = 1;
+
+	const set<Upgrade::Type> upgrades = {
+		Upgrade::Type::GATLING, Upgrade::Type::LASER, Upgrade::Type::BOMB, Upgrade::Type::RC_MISSILE,
+		Upgrade::Type::HOMING_MISSILE, Upgrade::Type::MINES, Upgrade::Type::DEATH_RAY
+	};
+	GameBatch batch(games, tanks, MazeGeneration::EXPAND_TREE, upgrades, seed, threads);
+
+	vector<float> observations((size_t)games * batch.get_observation_size());
+	vector<int> results(games);
+	vector<KeyState> keys((size_t)games * tanks);
+	mt19937 random(seed);
+
+	uint64_t rounds = 0, step_ns = 0;
+	for(int step = 0; step < steps; step++){
+		for(auto& key: keys){
+			unsigned int bits = random();
+			key = KeyState(bits & 1, bits & 2, bits & 12, (bits & 48) == 48, (bits & 192) == 192);
+		}
+
+		auto start = chrono::steady_clock::now();
+		batch.step(keys.data(), observations.data(), results.data());
+		step_ns += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+
+		for(int result: results) rounds += result != BATCH_ROUND_RUNNING;
+	}
+
+	double seconds = step_ns / 1e9;
+	double ticks_per_second = seconds > 0 ? (double)games * steps / seconds : 0;
+	cerr << games << " games x " << steps << " steps, " << tanks << " tanks, " << threads << " threads, seed " << seed << endl
+		<< fixed << setprecision(1)
+		<< "game ticks/s   " << ticks_per_second << endl
+		<< "batch steps/s  " << (seconds > 0 ? steps / seconds : 0) << endl
+		<< "rounds played  " << rounds << endl;
+
+	cout << "{" << endl
+		<< "  \"suite\": \"batch\"," << endl
+		<< "  \"games\": " << games << ", \"steps\": " << steps << ", \"tanks\": " << tanks
+		<< ", \"threads\": " << threads << ", \"seed\": " << seed << "," << endl
+		<< "  \"metrics\": {" << endl << fixed << setprecision(3)
+		<< "    \"game_ticks_per_second\": " << ticks_per_second << "," << endl
+		<< "    \"rounds\": " << rounds << endl
+		<< "  }" << endl
+		<< "}" << endl;
+	return 0;
+}
@@ -0,0 +1,77 @@
+#include "bench.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+
+Bench::Bench(int argc, char** argv) : sample_ms(20), samples(15) {
+	for(int i = 1; i + 1 < argc; i += 2){
+		string option = argv[i];
+		if(option == "--filter") filter = argv[i + 1];
+		if(option == "--samples") samples = atoi(argv[i + 1]);
+		if(option == "--sample-ms") sample_ms = atof(argv[i + 1]);
+	}
+	if(samples < 2) samples = 2;
+}
+
+bool Bench::selected(const char* name) const{
+	return filter.empty() || string(name).find(filter) != string::npos;
+}
+
+void Bench::add(const char* name, long long iterations, const vector<double>& sample_ns){
+	double sum = 0, min_ns = sample_ns[0];
+	for(double value: sample_ns){
+		sum += value;
+		if(value < min_ns) min_ns = value;
+	}
+	double mean = sum / sample_ns.size();
+
+	double variance = 0;
+	for(double value: sample_ns) variance += (value - mean) * (value - mean);
+	variance /= sample_ns.size() - 1;
+
+	results.push_back({
+		.name = name,
+		.iterations = iterations,
+		.samples = (int)sample_ns.size(),
+		.mean_ns = mean,
+		.stddev_ns = sqrt(variance),
+		.min_ns = min_ns
+	});
+}
+
+const vector<BenchResult>& Bench::get_results() const{
+	return results;
+}
+
+void Bench::print(ostream& output) const{
+	output << left << setw(40) << "benchmark" << right
+		<< setw(14) << "ns/op"
+		<< setw(12) << "stddev"
+		<< setw(14) << "min ns/op"
+		<< setw(14) << "iterations" << endl;
+	for(const auto& result: results){
+		output << left << setw(40) << result.name << right << fixed << setprecision(1)
+			<< setw(14) << result.mean_ns
+			<< setw(11) << (result.mean_ns > 0 ? 100 * result.stddev_ns / result.mean_ns : 0) << "%"
+			<< setw(14) << result.min_ns
+			<< setw(14) << result.iterations << endl;
+	}
+}
+
+void Bench::write_json(ostream& output, const string& suite) const{
+	output << "{" << endl
+		<< "  \"suite\": \"" << suite << "\"," << endl
+		<< "  \"benchmarks\": [";
+	for(int i = 0; i < results.size(); i++){
+		const auto& result = results[i];
+		output << (i ? "," : "") << endl << fixed << setprecision(3)
+			<< "    {\"name\": \"" << result.name << "\""
+			<< ", \"ns_per_op\": " << result.mean_ns
+			<< ", \"stddev_ns\": " << result.stddev_ns
+			<< ", \"min_ns\": " << result.min_ns
+			<< ", \"samples\": " << result.samples
+			<< ", \"iterations\": " << result.iterations << "}";
+	}
+	output << endl << "  ]" << endl << "}" << endl;
+}
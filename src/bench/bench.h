@@ -0,0 +1,68 @@
+#ifndef _BENCH_H
+#define _BENCH_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <ostream>
+
+using namespace std;
+
+// Keeps the compiler from optimizing away a benchmarked result
+template<typename T>
+inline void keep(const T& value){
+	asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct BenchResult{
+	string name;
+	long long iterations;  // Per sample
+	int samples;
+	double mean_ns, stddev_ns, min_ns;  // Per operation
+};
+
+class Bench{
+	vector<BenchResult> results;
+	string filter;
+	double sample_ms;
+	int samples;
+
+	bool selected(const char* name) const;
+	void add(const char* name, long long iterations, const vector<double>& sample_ns);
+public:
+	// Arguments: [--filter <substring>] [--samples <n>] [--sample-ms <ms>]
+	Bench(int argc, char** argv);
+
+	// Times body(), which runs one operation, in repeated samples after calibrating the iteration count
+	template<typename F>
+	void run(const char* name, F body){
+		if(!selected(name)) return;
+
+		long long iterations = 1;
+		while(true){
+			auto start = chrono::steady_clock::now();
+			for(long long i = 0; i < iterations; i++) body();
+			chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+			if(elapsed.count() >= sample_ms || iterations >= (1LL << 40)) break;
+			iterations *= elapsed.count() > sample_ms / 16 ? 2 : 8;
+		}
+
+		vector<double> sample_ns;
+		for(int sample = 0; sample < samples; sample++){
+			auto start = chrono::steady_clock::now();
+			for(long long i = 0; i < iterations; i++) body();
+			chrono::duration<double, nano> elapsed = chrono::steady_clock::now() - start;
+			sample_ns.push_back(elapsed.count() / iterations);
+		}
+		add(name, iterations, sample_ns);
+	}
+
+	const vector<BenchResult>& get_results() const;
+
+	// Human readable table
+	void print(ostream& output) const;
+	// Machine readable results
+	void write_json(ostream& output, const string& suite) const;
+};
+
+#endif
@@ -0,0 +1,526 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "reference.h"
+
+#include "../game/logic/logic.h"
+#include "../game/logic/geometry.h"
+#include "../game/logic/maze.h"
+#include "../utils/utils.h"
+
+using namespace std;
+
+#define MAZE_COUNT 8
+#define DEATH_RAY_TANKS 4
+#define SHOT_TANKS 2
+
+// In cells, for the kernels that changed on purpose: how far they may move from the old ones
+// before it is reported, and from their exact oracles before it counts as parted
+#define DIFF_TOLERANCE 0.01
+#define ORACLE_TOLERANCE 0.001
+// Share of shots allowed to part from their oracle. The oracle is exact, the game's shots round to fixed point:
+// where they graze the end of a wall that decides which ways they bounce, and the sweeps of shots moving
+// within a hair of a wall's direction overflow.
+#define ORACLE_PARTED_SHARE 0.005
+
+// Bitwise equality, the fast paths must not even differ in rounding
+static bool same(Number number1, Number number2){
+	return memcmp(&number1, &number2, sizeof(Number)) == 0;
+}
+static bool same(const Point& point1, const Point& point2){
+	return same(point1.x, point2.x) && same(point1.y, point2.y);
+}
+static bool same(const Collision& collision1, const Collision& collision2){
+	return same(collision1.position, collision2.position) &&
+		same(collision1.normal, collision2.normal) &&
+		same(collision1.depth, collision2.depth);
+}
+static bool same(int value1, int value2){
+	return value1 == value2;
+}
+static bool same(const Contacts& contacts1, const Contacts& contacts2){
+	if(contacts1.size() != contacts2.size()) return false;
+	for(int i = 0; i < contacts1.size(); i++){
+		if(!same(contacts1[i], contacts2[i])) return false;
+	}
+	return true;
+}
+static bool same(const TankState& tank1, const TankState& tank2){
+	return same(tank1.position, tank2.position) && same(tank1.direction, tank2.direction) && tank1.heading == tank2.heading;
+}
+
+struct CollisionResult{
+	bool hit;
+	Collision collision;
+};
+static bool same(const CollisionResult& result1, const CollisionResult& result2){
+	return result1.hit == result2.hit && same(result1.collision, result2.collision);
+}
+
+struct SweepResult{
+	bool hit;
+	Point normal;
+	Number fraction;
+};
+static bool same(const SweepResult& result1, const SweepResult& result2){
+	return result1.hit == result2.hit && same(result1.normal, result2.normal) && same(result1.fraction, result2.fraction);
+}
+
+struct ShotResult{
+	int tank, ignored_tank;
+	ShotDetails shot;
+	vector<TimePoint> path;
+};
+static bool same(const ShotResult& result1, const ShotResult& result2){
+	if(result1.tank != result2.tank || result1.ignored_tank != result2.ignored_tank) return false;
+	if(!same(result1.shot.position, result2.shot.position) || !same(result1.shot.velocity, result2.shot.velocity)) return false;
+	if(result1.path.size() != result2.path.size()) return false;
+	for(int i = 0; i < result1.path.size(); i++){
+		if(!same(result1.path[i].point, result2.path[i].point) || !same(result1.path[i].time, result2.path[i].time)) return false;
+	}
+	return true;
+}
+// A different hit or number of bounces counts as arbitrarily far
+static double difference(const ShotResult& result1, const ShotResult& result2){
+	if(result1.tank != result2.tank || result1.path.size() != result2.path.size()) return INFINITY;
+	return length(result1.shot.position - result2.shot.position);
+}
+
+// Where the ray stops, or 2 past its end when it hits nothing
+struct ShrapnelResult{
+	Number fraction;
+	Point stop;
+};
+static bool same(const ShrapnelResult& result1, const ShrapnelResult& result2){
+	return same(result1.fraction, result2.fraction);
+}
+static double difference(const ShrapnelResult& result1, const ShrapnelResult& result2){
+	if(((double)result1.fraction > 1) != ((double)result2.fraction > 1)) return INFINITY;
+	return length(result1.stop - result2.stop);
+}
+
+struct DisplacementResult{
+	bool moved;
+	Point displacement;
+};
+static bool same(const DisplacementResult& result1, const DisplacementResult& result2){
+	return result1.moved == result2.moved && same(result1.displacement, result2.displacement);
+}
+
+struct Pose{
+	int maze;
+	Point position, direction;
+};
+
+class Inputs{
+	mt19937 random;
+public:
+	vector<Maze> mazes;
+
+	Inputs(unsigned int seed) : random(seed) {
+		for(int i = 0; i < MAZE_COUNT; i++){
+			seed_random(seed + i);
+			mazes.push_back(generate_maze(MazeGeneration::EXPAND_TREE, rand_range(5, 12), rand_range(5, 12)));
+		}
+	}
+
+	int integer(int count){
+		return random() % count;
+	}
+	double uniform(double low, double high){
+		return uniform_real_distribution<double>(low, high)(random);
+	}
+
+	// Half on the discrete headings, like most tanks in a game, half anywhere
+	Point direction(){
+		if(random() % 2) return get_heading_direction(random_heading());
+		double angle = uniform(0, 2 * M_PI);
+		Point result = { .x = cos(angle), .y = sin(angle) };
+		normalize(result);
+		return result;
+	}
+
+	Pose pose(){
+		int maze = random() % mazes.size();
+		return {
+			.maze = maze,
+			.position = { .x = uniform(0.05, mazes[maze].get_w() - 0.05), .y = uniform(0.05, mazes[maze].get_h() - 0.05) },
+			.direction = direction()
+		};
+	}
+
+	// Clear of every wall of its cell, as the game keeps its shots
+	Pose clear_pose(double radius){
+		const double margin = (double)WALL_WIDTH + radius;
+		auto result = pose();
+		result.position = {
+			.x = floor((double)result.position.x) + uniform(margin, 1 - margin),
+			.y = floor((double)result.position.y) + uniform(margin, 1 - margin)
+		};
+		return result;
+	}
+
+	Point offset(double range){
+		return { .x = uniform(-range, range), .y = uniform(-range, range) };
+	}
+
+	TankState tank(const Pose& pose){
+		return TankState(pose.position, pose.direction, -1, KeyState(), true, true);
+	}
+};
+
+struct Timings{
+	double reference_ns, fast_ns;
+};
+
+// Runs both implementations over the same cases
+template<typename Result, typename Reference, typename Fast>
+static Timings run_both(int cases, Reference reference, Fast fast, vector<Result>& expected, vector<Result>& actual){
+	expected.reserve(cases);
+	actual.reserve(cases);
+
+	auto start = chrono::steady_clock::now();
+	for(int i = 0; i < cases; i++) expected.push_back(reference(i));
+	chrono::duration<double, nano> reference_time = chrono::steady_clock::now() - start;
+
+	start = chrono::steady_clock::now();
+	for(int i = 0; i < cases; i++) actual.push_back(fast(i));
+	chrono::duration<double, nano> fast_time = chrono::steady_clock::now() - start;
+
+	return { .reference_ns = reference_time.count() / cases, .fast_ns = fast_time.count() / cases };
+}
+
+static void print_row(const char* name, int cases, int mismatches, const Timings& timings){
+	cout << left << setw(34) << name << right
+		<< setw(10) << cases
+		<< setw(12) << mismatches
+		<< fixed << setprecision(1)
+		<< setw(14) << timings.reference_ns
+		<< setw(12) << timings.fast_ns
+		<< setw(9) << timings.reference_ns / timings.fast_ns << "x";
+}
+
+// Fails on any result the reference does not accept, reports the speedup
+template<typename Result, typename Reference, typename Fast, typename Accept>
+static bool gate(const char* name, int cases, Reference reference, Fast fast, Accept accept){
+	vector<Result> expected, actual;
+	auto timings = run_both(cases, reference, fast, expected, actual);
+
+	int mismatches = 0, first_mismatch = -1;
+	for(int i = 0; i < cases; i++){
+		if(accept(expected[i], actual[i])) continue;
+		if(first_mismatch < 0) first_mismatch = i;
+		mismatches++;
+	}
+
+	print_row(name, cases, mismatches, timings);
+	if(mismatches) cout << "  first mismatch at case " << first_mismatch;
+	return mismatches == 0;
+}
+
+// Bitwise equal to the reference
+template<typename Result, typename Reference, typename Fast>
+static bool differential(const char* name, int cases, Reference reference, Fast fast){
+	bool passed = gate<Result>(name, cases, reference, fast, [](const Result& expected, const Result& actual){
+		return same(expected, actual);
+	});
+	cout << endl;
+	return passed;
+}
+
+// Within tolerance of an exact oracle for all but a share of the cases, the largest accepted difference is reported
+template<typename Result, typename Reference, typename Fast>
+static bool differential(const char* name, int cases, double tolerance, double parted_share, Reference oracle, Fast fast){
+	double largest = 0;
+	int parted = 0;
+	gate<Result>(name, cases, oracle, fast, [&](const Result& expected, const Result& actual){
+		if(same(expected, actual)) return true;
+		double current = difference(expected, actual);
+		if(current > tolerance){
+			parted++;
+			return false;
+		}
+		largest = max(largest, current);
+		return true;
+	});
+	cout << scientific << setprecision(1) << "  largest difference " << largest
+		<< fixed << setprecision(3) << ", " << 100.0 * parted / cases << "% parted, allowed " << 100 * parted_share << "%" << endl;
+	return parted <= parted_share * cases;
+}
+
+// For kernels whose results changed on purpose: reports how often they differ from the old ones,
+// and how often by more than DIFF_TOLERANCE, without failing
+template<typename Result, typename Reference, typename Fast>
+static void changed(const char* name, int cases, Reference reference, Fast fast){
+	vector<Result> expected, actual;
+	auto timings = run_both(cases, reference, fast, expected, actual);
+
+	int mismatches = 0, far = 0;
+	for(int i = 0; i < cases; i++){
+		if(same(expected[i], actual[i])) continue;
+		mismatches++;
+		if(difference(expected[i], actual[i]) > DIFF_TOLERANCE) far++;
+	}
+
+	print_row(name, cases, mismatches, timings);
+	cout << fixed << setprecision(3)
+		<< "  changed: " << 100.0 * mismatches / cases << "% differ, "
+		<< 100.0 * far / cases << "% by more than " << DIFF_TOLERANCE << endl;
+}
+
+// Arguments: [--cases <n>] [--seed <n>]
+int main(int argc, char** argv){
+	int cases = 1000000;
+	unsigned int seed = 1;
+	for(int i = 1; i + 1 < argc; i += 2){
+		string option = argv[i];
+		if(option == "--cases") cases = atoi(argv[i + 1]);
+		if(option == "--seed") seed = atoi(argv[i + 1]);
+	}
+	// Maze wide brute force references are far slower, they get fewer cases
+	const int sweep_cases = max(1, cases / 20);
+
+	Inputs inputs(seed);
+	bool passed = true;
+
+	cout << left << setw(34) << "kernel" << right
+		<< setw(10) << "cases"
+		<< setw(12) << "mismatches"
+		<< setw(14) << "reference ns"
+		<< setw(12) << "fast ns"
+		<< setw(10) << "speedup" << endl;
+
+	// Tank against tank, close enough to overlap about half of the time
+	{
+		vector<Pose> poses1, poses2;
+		for(int i = 0; i < cases; i++){
+			poses1.push_back(inputs.pose());
+			poses2.push_back(poses1.back());
+			poses2.back().position += inputs.offset(0.5);
+			poses2.back().direction = inputs.direction();
+		}
+		passed &= differential<CollisionResult>("polygon_collision", cases, [&](int i){
+			CollisionResult result = { .hit = false, .collision = { .position = { .x = 0, .y = 0 }, .normal = { .x = 0, .y = 0 }, .depth = 0 } };
+			result.hit = reference_polygon_collision(
+				reference_get_rotated_rectangle(poses1[i].position, poses1[i].direction, TANK_WIDTH, TANK_LENGTH),
+				reference_get_rotated_rectangle(poses2[i].position, poses2[i].direction, TANK_WIDTH, TANK_LENGTH),
+				result.collision
+			);
+			return result;
+		}, [&](int i){
+			CollisionResult result = { .hit = false, .collision = { .position = { .x = 0, .y = 0 }, .normal = { .x = 0, .y = 0 }, .depth = 0 } };
+			result.hit = polygon_collision(
+				get_rotated_rectangle(poses1[i].position, poses1[i].direction, TANK_WIDTH, TANK_LENGTH),
+				get_rotated_rectangle(poses2[i].position, poses2[i].direction, TANK_WIDTH, TANK_LENGTH),
+				result.collision
+			);
+			return result;
+		});
+	}
+
+	// Circles of shot sizes and speeds against tanks
+	{
+		vector<Pose> tanks;
+		vector<Point> positions, velocities;
+		vector<Number> radii;
+		for(int i = 0; i < cases; i++){
+			tanks.push_back(inputs.pose());
+			positions.push_back(tanks.back().position + inputs.offset(0.8));
+			velocities.push_back(inputs.direction() * inputs.uniform(0.01, 0.8));
+			radii.push_back(inputs.uniform(0, 0.05));
+		}
+		passed &= differential<SweepResult>("polygon_moving_circle_collision", cases, [&](int i){
+			SweepResult result = { .hit = false, .normal = { .x = 0, .y = 0 }, .fraction = 0 };
+			result.hit = reference_polygon_moving_circle_collision(
+				reference_get_rotated_rectangle(tanks[i].position, tanks[i].direction, TANK_WIDTH, TANK_LENGTH),
+				positions[i], velocities[i], radii[i],
+				result.normal, result.fraction
+			);
+			return result;
+		}, [&](int i){
+			SweepResult result = { .hit = false, .normal = { .x = 0, .y = 0 }, .fraction = 0 };
+			result.hit = polygon_moving_circle_collision(
+				get_rotated_rectangle(tanks[i].position, tanks[i].direction, TANK_WIDTH, TANK_LENGTH),
+				positions[i], velocities[i], radii[i],
+				result.normal, result.fraction
+			);
+			return result;
+		});
+	}
+
+	// Tank poses in mazes, then the displacement out of the walls they touch
+	{
+		vector<Pose> poses;
+		for(int i = 0; i < cases; i++) poses.push_back(inputs.pose());
+		passed &= differential<Contacts>("tank_wall_contacts", cases, [&](int i){
+			Contacts result;
+			for(const auto& collision: reference_get_tank_collisions(inputs.tank(poses[i]), inputs.mazes[poses[i].maze])){
+				result.push_back(collision);
+			}
+			return result;
+		}, [&](int i){
+			return get_tank_collisions(inputs.tank(poses[i]), inputs.mazes[poses[i].maze]);
+		});
+
+		vector<vector<Collision>> contacts;
+		for(int i = 0; contacts.size() < cases && i < 50 * cases; i++){
+			auto pose = inputs.pose();
+			auto collisions = reference_get_tank_collisions(inputs.tank(pose), inputs.mazes[pose.maze]);
+			if(!collisions.empty()) contacts.push_back(collisions);
+		}
+		vector<Contacts> fixed_contacts;
+		for(const auto& collisions: contacts){
+			fixed_contacts.emplace_back();
+			for(const auto& collision: collisions) fixed_contacts.back().push_back(collision);
+		}
+		passed &= differential<DisplacementResult>("get_collision_displacement", contacts.size(), [&](int i){
+			DisplacementResult result = { .moved = false, .displacement = { .x = 0, .y = 0 } };
+			result.moved = reference_get_collision_displacement(contacts[i], result.displacement);
+			return result;
+		}, [&](int i){
+			DisplacementResult result = { .moved = false, .displacement = { .x = 0, .y = 0 } };
+			result.moved = get_collision_displacement(fixed_contacts[i], result.displacement);
+			return result;
+		});
+	}
+
+	// Whole tank moves, half on the discrete headings, with every combination of keys
+	{
+		vector<TankState> tanks;
+		vector<int> mazes;
+		for(int i = 0; i < cases; i++){
+			auto pose = inputs.pose();
+			mazes.push_back(pose.maze);
+			int heading = inputs.integer(2) ? random_heading() : -1;
+			if(heading >= 0) pose.direction = get_heading_direction(heading);
+			int keys = inputs.integer(16);
+			tanks.push_back(TankState(pose.position, pose.direction, heading, KeyState(keys & 1, keys & 2, keys & 4, keys & 8, false), true, true));
+		}
+		passed &= differential<TankState>("advance_tank", cases, [&](int i){
+			TankState tank = tanks[i];
+			reference_advance_tank(tank, inputs.mazes[mazes[i]]);
+			return tank;
+		}, [&](int i){
+			TankState tank = tanks[i];
+			advance_tank(tank, inputs.mazes[mazes[i]]);
+			return tank;
+		});
+	}
+
+	// Shots of every speed up to lasers, through mazes and past a couple of tanks.
+	// Shots used to move in half cell steps testing only the walls of their cell,
+	// they now sweep the cells they cross.
+	{
+		vector<Pose> shots;
+		vector<Number> radii;
+		vector<vector<TankState>> tanks;
+		vector<int> ignored_tanks;
+		for(int i = 0; i < sweep_cases; i++){
+			radii.push_back(inputs.uniform(0.005, 0.05));
+			shots.push_back(inputs.clear_pose(radii.back()));
+			shots.back().direction = shots.back().direction * inputs.uniform(0.01, 2);
+
+			tanks.emplace_back();
+			for(int tank = 0; tank < SHOT_TANKS; tank++){
+				auto pose = shots.back();
+				pose.position += inputs.offset(1.5);
+				pose.direction = inputs.direction();
+				tanks.back().push_back(inputs.tank(pose));
+			}
+			ignored_tanks.push_back(inputs.integer(SHOT_TANKS + 1) - 1);
+		}
+		auto shoot = [&](int i, auto advance){
+			vector<const TankState*> tank_pointers;
+			for(const auto& tank: tanks[i]) tank_pointers.push_back(&tank);
+
+			ShotResult result = {
+				.tank = -1,
+				.ignored_tank = ignored_tanks[i],
+				.shot = ShotDetails(shots[i].position, shots[i].direction, radii[i], 0, ShotDetails::Type::ROUND, 0),
+				.path = {}
+			};
+			result.tank = advance(result.shot, inputs.mazes[shots[i].maze], tank_pointers, result.ignored_tank, result.path);
+			return result;
+		};
+		changed<ShotResult>("advance_shot", sweep_cases, [&](int i){
+			return shoot(i, reference_advance_shot);
+		}, [&](int i){
+			return shoot(i, advance_shot);
+		});
+		passed &= differential<ShotResult>("advance_shot oracle", sweep_cases, ORACLE_TOLERANCE, ORACLE_PARTED_SHARE, [&](int i){
+			return shoot(i, oracle_advance_shot);
+		}, [&](int i){
+			return shoot(i, advance_shot);
+		});
+	}
+
+	// Shrapnel rays of explosion range. They used to be sampled in short sections,
+	// they are now cast through the wall grid.
+	{
+		vector<int> mazes;
+		vector<ShrapnelDetails> shrapnels;
+		for(int i = 0; i < sweep_cases; i++){
+			auto pose = inputs.pose();
+			mazes.push_back(pose.maze);
+			shrapnels.emplace_back(pose.position, pose.direction * inputs.uniform(0.1, 5));
+		}
+		auto cast = [&](int i, auto collision){
+			Number fraction = collision(shrapnels[i], inputs.mazes[mazes[i]]);
+			return ShrapnelResult{ .fraction = fraction, .stop = shrapnels[i].start + shrapnels[i].distance * fraction };
+		};
+		changed<ShrapnelResult>("shrapnel_wall_collision", sweep_cases, [&](int i){
+			return cast(i, reference_shrapnel_wall_collision);
+		}, [&](int i){
+			return cast(i, get_shrapnel_wall_collision);
+		});
+		passed &= differential<ShrapnelResult>("shrapnel_wall_collision oracle", sweep_cases, ORACLE_TOLERANCE, 0, [&](int i){
+			return cast(i, oracle_shrapnel_wall_collision);
+		}, [&](int i){
+			return cast(i, get_shrapnel_wall_collision);
+		});
+	}
+
+	// Death ray paths against a handful of tanks, compiling the path is part of the fast side
+	{
+		vector<vector<Point>> paths;
+		vector<vector<TankState>> tanks;
+		for(int i = 0; i < cases / 10; i++){
+			auto start = inputs.pose();
+			paths.push_back({ start.position });
+			int points = 2 + inputs.integer(7);
+			for(int point = 1; point < points; point++) paths.back().push_back(paths.back().back() + inputs.offset(3));
+
+			tanks.emplace_back();
+			for(int tank = 0; tank < DEATH_RAY_TANKS; tank++){
+				auto pose = start;
+				pose.position += inputs.offset(3);
+				pose.direction = inputs.direction();
+				tanks.back().push_back(inputs.tank(pose));
+			}
+		}
+		passed &= differential<int>("death_ray_collision", paths.size(), [&](int i){
+			int hits = 0;
+			for(int tank = 0; tank < DEATH_RAY_TANKS; tank++){
+				if(reference_check_death_ray_collision(paths[i], tanks[i][tank])) hits |= 1 << tank;
+			}
+			return hits;
+		}, [&](int i){
+			const auto segments = compile_death_ray(paths[i]);
+			int hits = 0;
+			for(int tank = 0; tank < DEATH_RAY_TANKS; tank++){
+				if(check_death_ray_collision(segments, tanks[i][tank])) hits |= 1 << tank;
+			}
+			return hits;
+		});
+	}
+
+	cout << (passed ? "All kernels match their references and oracles" : "MISMATCH between optimized kernels and their references or oracles") << endl;
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,193 @@
+#include "macro.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+#ifdef __GLIBC__
+#include <malloc.h>
+#define ALLOCATION_SIZE(pointer) malloc_usable_size(pointer)
+#else
+#define ALLOCATION_SIZE(pointer) 0
+#endif
+
+#include "../game/logic/game.h"
+#include "../utils/utils.h"
+
+// Every heap allocation of the process is counted, so the ticks can be checked for allocations,
+// and live heap memory is tracked where the allocator can tell the size of a block
+static atomic<uint64_t> allocation_count(0), allocated_bytes(0);
+static atomic<uint64_t> live_bytes(0), peak_live_bytes(0);
+
+void* operator new(size_t size){
+	void* result = malloc(size ? size : 1);
+	if(result == nullptr) throw bad_alloc();
+
+	allocation_count.fetch_add(1, memory_order_relaxed);
+	allocated_bytes.fetch_add(size, memory_order_relaxed);
+	uint64_t live = live_bytes.fetch_add(ALLOCATION_SIZE(result), memory_order_relaxed) + ALLOCATION_SIZE(result);
+	uint64_t peak = peak_live_bytes.load(memory_order_relaxed);
+	while(live > peak && !peak_live_bytes.compare_exchange_weak(peak, live, memory_order_relaxed));
+	return result;
+}
+void* operator new[](size_t size){
+	return operator new(size);
+}
+void operator delete(void* pointer) noexcept{
+	if(pointer == nullptr) return;
+	live_bytes.fetch_sub(ALLOCATION_SIZE(pointer), memory_order_relaxed);
+	free(pointer);
+}
+void operator delete[](void* pointer) noexcept{
+	operator delete(pointer);
+}
+void operator delete(void* pointer, size_t) noexcept{
+	operator delete(pointer);
+}
+void operator delete[](void* pointer, size_t) noexcept{
+	operator delete(pointer);
+}
+
+static long get_peak_rss_kb(){
+#ifndef _WIN32
+	struct rusage usage;
+	if(getrusage(RUSAGE_SELF, &usage) == 0) return usage.ru_maxrss;
+#endif
+	return 0;
+}
+
+// Holds a random key combination for a random number of ticks, like a player mashing keys,
+// and either holds the trigger (gatling, lasers), taps it or leaves it
+class ScriptedDriver{
+	mt19937 random;
+	KeyState keys;
+	int remaining, shoot_mode;
+public:
+	ScriptedDriver(unsigned int seed) : random(seed), remaining(0), shoot_mode(0) {}
+
+	KeyState next(){
+		if(--remaining <= 0){
+			remaining = 5 + random() % 40;
+			bool turn = random() % 2;
+			keys = KeyState(
+				turn && random() % 2, turn && random() % 2,
+				random() % 3 != 0, random() % 6 == 0,
+				false
+			);
+			shoot_mode = random() % 3;
+		}
+		keys.shoot = shoot_mode == 1 || (shoot_mode == 2 && random() % 4 == 0);
+		return keys;
+	}
+};
+
+MacroOptions get_default_macro_options(){
+	return { .games = 8, .ticks = 3000, .tanks = 4, .seed = 1 };
+}
+
+MacroResult run_macro_bench(const MacroOptions& options){
+	const set<Upgrade::Type> upgrades = {
+		Upgrade::Type::GATLING, Upgrade::Type::LASER, Upgrade::Type::BOMB, Upgrade::Type::RC_MISSILE,
+		Upgrade::Type::HOMING_MISSILE, Upgrade::Type::MINES, Upgrade::Type::DEATH_RAY
+	};
+	const vector<Upgrade::Type> upgrade_cycle(upgrades.begin(), upgrades.end());
+
+	MacroResult result = {};
+	vector<uint64_t> tick_ns;
+	tick_ns.reserve((size_t)options.games * options.ticks);
+	uint64_t tick_allocations = 0, tick_allocated_bytes = 0, total_ns = 0;
+	uint64_t shots = 0, missiles = 0, shrapnels = 0;
+
+	for(int game_index = 0; game_index < options.games; game_index++){
+		vector<ScriptedDriver> drivers;
+		for(int tank = 0; tank < options.tanks; tank++){
+			drivers.emplace_back(options.seed * 1000 + game_index * 16 + tank);
+		}
+
+		unique_ptr<Game> game;
+		int next_upgrade = 0;
+		uint64_t match_start_bytes = 0;
+		auto finish_match = [&](){
+			result.match_peak_heap_bytes = max(result.match_peak_heap_bytes, (size_t)(
+				peak_live_bytes.load(memory_order_relaxed) - match_start_bytes
+			));
+			result.arena_peak_bytes = max(result.arena_peak_bytes, game->get_arena_peak_bytes());
+#ifdef TICK_PROFILING
+			result.profile.merge(game->get_tick_profile());
+#endif
+		};
+
+		for(int tick = 0; tick < options.ticks; tick++){
+			// A match ends with at most one tank left, the next one is played on a new maze
+			int alive = 0;
+			if(game != nullptr) for(const auto& tank: game->get_states()) alive += tank.state.alive;
+			if(alive <= 1){
+				if(game != nullptr) finish_match();
+				game.reset();
+				match_start_bytes = live_bytes.load(memory_order_relaxed);
+				peak_live_bytes.store(match_start_bytes, memory_order_relaxed);
+				seed_random(options.seed * 1000 + game_index * 100 + result.matches);
+				game = make_unique<Game>(MazeGeneration::EXPAND_TREE, upgrades, options.tanks);
+				result.matches++;
+			}
+
+			// Tanks are handed every upgrade type in turn so all weapons stay in play
+			const auto states = game->get_states();
+			for(int tank = 0; tank < options.tanks; tank++){
+				if(states[tank].state.alive && states[tank].upgrade == nullptr){
+					game->upgrade_tank(tank, upgrade_cycle[next_upgrade++ % upgrade_cycle.size()]);
+				}
+			}
+
+			uint64_t allocations_before = allocation_count.load(memory_order_relaxed);
+			uint64_t bytes_before = allocated_bytes.load(memory_order_relaxed);
+			auto start = chrono::steady_clock::now();
+
+			for(int tank = 0; tank < options.tanks; tank++){
+				game->get_player_interface(tank).step(game->get_round(), drivers[tank].next());
+			}
+			game->allow_step();
+			game->advance();
+
+			uint64_t elapsed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+			tick_allocations += allocation_count.load(memory_order_relaxed) - allocations_before;
+			tick_allocated_bytes += allocated_bytes.load(memory_order_relaxed) - bytes_before;
+			tick_ns.push_back(elapsed);
+			total_ns += elapsed;
+
+			shots += game->get_shots().size();
+			missiles += game->get_missiles().size();
+			shrapnels += game->get_shrapnels().size();
+		}
+		if(game != nullptr) finish_match();
+	}
+
+	result.ticks = tick_ns.size();
+	if(tick_ns.empty()) return result;
+
+	auto quantile = [&](double fraction){
+		size_t index = min(tick_ns.size() - 1, (size_t)(fraction * tick_ns.size()));
+		nth_element(tick_ns.begin(), tick_ns.begin() + index, tick_ns.end());
+		return tick_ns[index];
+	};
+	const double ticks = tick_ns.size();
+	result.tick_p50_ns = quantile(0.5);
+	result.tick_p99_ns = quantile(0.99);
+	result.tick_max_ns = *max_element(tick_ns.begin(), tick_ns.end());
+	result.ticks_per_second = total_ns ? ticks * 1e9 / total_ns : 0;
+	result.allocations_per_tick = tick_allocations / ticks;
+	result.allocated_bytes_per_tick = tick_allocated_bytes / ticks;
+	result.shots_per_tick = shots / ticks;
+	result.missiles_per_tick = missiles / ticks;
+	result.shrapnels_per_tick = shrapnels / ticks;
+	result.peak_rss_kb = get_peak_rss_kb();
+	return result;
+}
@@ -0,0 +1,36 @@
+#ifndef _MACRO_H
+#define _MACRO_H
+
+#include <cstdint>
+#include <cstddef>
+
+#include "../game/logic/tick_profile.h"
+
+using namespace std;
+
+struct MacroOptions{
+	int games, ticks, tanks;  // Each game is a separate driver script, replaying matches for the given ticks
+	unsigned int seed;
+};
+
+struct MacroResult{
+	int matches;
+	uint64_t ticks;
+	double ticks_per_second;
+	uint64_t tick_p50_ns, tick_p99_ns, tick_max_ns;
+	double allocations_per_tick, allocated_bytes_per_tick;
+	double shots_per_tick, missiles_per_tick, shrapnels_per_tick;
+	size_t match_peak_heap_bytes;  // Heap growth of the most demanding match, 0 where block sizes are unknown
+	size_t arena_peak_bytes;
+	long peak_rss_kb;
+#ifdef TICK_PROFILING
+	TickProfile profile;  // Merged over all matches
+#endif
+};
+
+MacroOptions get_default_macro_options();
+
+// Plays seeded matches with scripted drivers and every upgrade type in play
+MacroResult run_macro_bench(const MacroOptions& options);
+
+#endif
@@ -0,0 +1,63 @@
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "macro.h"
+
+using namespace std;
+
+int main(int argc, char** argv){
+	auto options = get_default_macro_options();
+	bool profile = false;
+	for(int i = 1; i < argc; i++){
+		string option = argv[i];
+		if(option == "--profile") profile = true;
+		else if(i + 1 < argc){
+			if(option == "--games") options.games = atoi(argv[i + 1]);
+			if(option == "--ticks") options.ticks = atoi(argv[i + 1]);
+			if(option == "--tanks") options.tanks = atoi(argv[i + 1]);
+			if(option == "--seed") options.seed = atoi(argv[i + 1]);
+			i++;
+		}
+	}
+
+	const auto result = run_macro_bench(options);
+
+	cerr << options.games << " games x " << options.ticks << " ticks, " << options.tanks << " tanks, seed " << options.seed
+		<< ", " << result.matches << " matches" << endl
+		<< fixed << setprecision(1)
+		<< "ticks/s             " << result.ticks_per_second << endl
+		<< "tick p50/p99/max ns " << result.tick_p50_ns << " / " << result.tick_p99_ns << " / " << result.tick_max_ns << endl
+		<< setprecision(3)
+		<< "allocations/tick    " << result.allocations_per_tick << " (" << result.allocated_bytes_per_tick << " bytes)" << endl
+		<< "live shots/missiles/shrapnel per tick "
+		<< result.shots_per_tick << " / " << result.missiles_per_tick << " / " << result.shrapnels_per_tick << endl
+		<< "match peak heap     " << result.match_peak_heap_bytes << " bytes" << endl
+		<< "arena peak bytes    " << result.arena_peak_bytes << endl
+		<< "peak rss kb         " << result.peak_rss_kb << endl;
+
+#ifdef TICK_PROFILING
+	if(profile) result.profile.dump(cerr);
+#else
+	if(profile) cerr << "--profile needs a build with TICK_PROFILING=1" << endl;
+#endif
+
+	cout << "{" << endl
+		<< "  \"suite\": \"macro\"," << endl
+		<< "  \"games\": " << options.games << ", \"ticks\": " << options.ticks
+		<< ", \"tanks\": " << options.tanks << ", \"seed\": " << options.seed << ", \"matches\": " << result.matches << "," << endl
+		<< "  \"metrics\": {" << endl << fixed << setprecision(3)
+		<< "    \"ticks_per_second\": " << result.ticks_per_second << "," << endl
+		<< "    \"tick_p50_ns\": " << result.tick_p50_ns << "," << endl
+		<< "    \"tick_p99_ns\": " << result.tick_p99_ns << "," << endl
+		<< "    \"tick_max_ns\": " << result.tick_max_ns << "," << endl
+		<< "    \"allocations_per_tick\": " << result.allocations_per_tick << "," << endl
+		<< "    \"allocated_bytes_per_tick\": " << result.allocated_bytes_per_tick << "," << endl
+		<< "    \"match_peak_heap_bytes\": " << result.match_peak_heap_bytes << "," << endl
+		<< "    \"arena_peak_bytes\": " << result.arena_peak_bytes << "," << endl
+		<< "    \"peak_rss_kb\": " << result.peak_rss_kb << endl
+		<< "  }" << endl
+		<< "}" << endl;
+	return 0;
+}
@@ -0,0 +1,201 @@
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+#include "bench.h"
+
+#include "../game/batch/observation_encoder.h"
+#include "../game/logic/game.h"
+#include "../game/logic/logic.h"
+#include "../game/logic/geometry.h"
+#include "../game/logic/maze.h"
+#include "../utils/utils.h"
+#include "../utils/serialization.h"
+
+using namespace std;
+
+#define BENCH_SEED 1234
+#define BENCH_MAZE_W 12
+#define BENCH_MAZE_H 12
+
+static Point unit(double angle){
+	Point result = { .x = cos(angle), .y = sin(angle) };
+	normalize(result);
+	return result;
+}
+
+// Wall along x = 1 and wall along y = 1, laid out like the maze polygons
+static Quad get_vertical_wall(){
+	return {
+		{ .x = 1 + WALL_WIDTH, .y = -WALL_WIDTH },
+		{ .x = 1 + WALL_WIDTH, .y = 1 + WALL_WIDTH },
+		{ .x = 1 - WALL_WIDTH, .y = 1 + WALL_WIDTH },
+		{ .x = 1 - WALL_WIDTH, .y = -WALL_WIDTH },
+	};
+}
+static Quad get_horizontal_wall(){
+	return {
+		{ .x = 1 + WALL_WIDTH, .y = 1 - WALL_WIDTH },
+		{ .x = 1 + WALL_WIDTH, .y = 1 + WALL_WIDTH },
+		{ .x = -WALL_WIDTH, .y = 1 + WALL_WIDTH },
+		{ .x = -WALL_WIDTH, .y = 1 - WALL_WIDTH },
+	};
+}
+
+template<typename T>
+static void bench_round_trip(Bench& bench, const char* name, const T& value){
+	stringstream buffer;
+	bench.run(name, [&](){
+		buffer.seekp(0);
+		serialize_value(buffer, value);
+		buffer.seekg(0);
+		keep(deserialize_value<T>(buffer));
+	});
+}
+
+static void bench_geometry(Bench& bench){
+	const auto vertical_wall = get_vertical_wall(), horizontal_wall = get_horizontal_wall();
+	const auto touching_tank = get_rotated_rectangle({ .x = Number(102) / 100, .y = Number(1) / 2 }, unit(0.5), TANK_WIDTH, TANK_LENGTH);
+	const auto separate_tank = get_rotated_rectangle({ .x = Number(1) / 2, .y = Number(1) / 2 }, unit(0.5), TANK_WIDTH, TANK_LENGTH);
+
+	bench.run("polygon_collision/hit", [&](){
+		Collision collision = { .position = { .x = 0, .y = 0 }, .normal = { .x = 0, .y = 0 }, .depth = 0 };
+		keep(polygon_collision(touching_tank, vertical_wall, collision));
+		keep(collision);
+	});
+	bench.run("polygon_collision/miss", [&](){
+		Collision collision = { .position = { .x = 0, .y = 0 }, .normal = { .x = 0, .y = 0 }, .depth = 0 };
+		keep(polygon_collision(separate_tank, vertical_wall, collision));
+	});
+
+	const Point shot_position = { .x = Number(1) / 2, .y = Number(1) / 2 };
+	const Point laser_velocity = unit(0.2) * LASER_SPEED;
+	bench.run("polygon_moving_circle_collision/hit", [&](){
+		Point normal = { .x = 0, .y = 0 };
+		Number fraction = 0;
+		keep(polygon_moving_circle_collision(vertical_wall, shot_position, laser_velocity, LASER_RADIUS, normal, fraction));
+		keep(fraction);
+	});
+	const Point away_velocity = unit(3.3) * LASER_SPEED;
+	bench.run("polygon_moving_circle_collision/miss", [&](){
+		Point normal = { .x = 0, .y = 0 };
+		Number fraction = 0;
+		keep(polygon_moving_circle_collision(vertical_wall, shot_position, away_velocity, LASER_RADIUS, normal, fraction));
+	});
+
+	// Tank pushed into the corner of both walls
+	const auto corner_tank = get_rotated_rectangle({ .x = Number(85) / 100, .y = Number(85) / 100 }, unit(0.7), TANK_WIDTH, TANK_LENGTH);
+	Contacts contacts;
+	for(const auto& wall: { vertical_wall, horizontal_wall }){
+		Collision collision = { .position = { .x = 0, .y = 0 }, .normal = { .x = 0, .y = 0 }, .depth = 0 };
+		if(polygon_collision(corner_tank, wall, collision)) contacts.push_back(collision);
+	}
+	bench.run("get_collision_displacement/corner", [&](){
+		Point displacement = { .x = 0, .y = 0 };
+		keep(get_collision_displacement(contacts, displacement));
+		keep(displacement);
+	});
+}
+
+static void bench_maze(Bench& bench){
+	seed_random(BENCH_SEED);
+	const Maze maze = generate_maze(MazeGeneration::EXPAND_TREE, BENCH_MAZE_W, BENCH_MAZE_H);
+
+	int cell = 0;
+	bench.run("get_maze_polygons", [&](){
+		keep(get_maze_polygons(cell % BENCH_MAZE_W, cell / BENCH_MAZE_W % BENCH_MAZE_H, maze));
+		cell++;
+	});
+
+	seed_random(BENCH_SEED);
+	bench.run("generate_maze/expand_tree_12x12", [&](){
+		keep(generate_maze(MazeGeneration::EXPAND_TREE, BENCH_MAZE_W, BENCH_MAZE_H));
+	});
+
+	bench.run("maze_map/12x12", [&](){
+		MazeMap maze_map(maze);
+		keep(maze_map);
+	});
+}
+
+// Drives every tank of a game with the same scripted keys, turning and shooting in turns
+static void play(Game& game, int ticks){
+	for(int tick = 0; tick < ticks; tick++){
+		for(int i = 0; i < game.get_tank_states().size(); i++){
+			game.get_player_interface(i).step(game.get_round(), KeyState(tick % 40 < 10, false, true, false, tick % 30 == i));
+		}
+		game.allow_step();
+		game.advance();
+	}
+}
+
+static void bench_serialization(Bench& bench){
+	bench_round_trip(bench, "serializer/int", 123456789);
+	bench_round_trip(bench, "serializer/long_long", 1234567890123LL);
+	bench_round_trip(bench, "serializer/bool", true);
+	bench_round_trip(bench, "serializer/number", Number(12345) / 100);
+	bench_round_trip(bench, "serializer/point", Point({ .x = Number(1) / 3, .y = Number(7) / 3 }));
+	bench_round_trip(bench, "serializer/key_state", KeyState(true, false, true, false, true));
+	bench_round_trip(bench, "serializer/tank_state", TankState(
+		{ .x = Number(3) / 2, .y = Number(5) / 2 }, unit(0.5), -1, KeyState(), true, true
+	));
+	bench_round_trip(bench, "serializer/shot_details", ShotDetails(
+		{ .x = Number(3) / 2, .y = Number(5) / 2 }, unit(0.5) * LASER_SPEED,
+		LASER_RADIUS, LASER_TTL, ShotDetails::Type::LASER, 1
+	));
+
+	vector<int> values;
+	for(int i = 0; i < 100; i++) values.push_back(i * 7919);
+	bench_round_trip(bench, "serializer/vector_int_100", values);
+
+	seed_random(BENCH_SEED);
+	bench_round_trip(bench, "serializer/maze_12x12", generate_maze(MazeGeneration::EXPAND_TREE, BENCH_MAZE_W, BENCH_MAZE_H));
+
+	seed_random(BENCH_SEED);
+	Game game(MazeGeneration::EXPAND_TREE, {
+		Upgrade::Type::GATLING, Upgrade::Type::LASER, Upgrade::Type::BOMB, Upgrade::Type::RC_MISSILE,
+		Upgrade::Type::HOMING_MISSILE, Upgrade::Type::MINES, Upgrade::Type::DEATH_RAY
+	}, 4);
+	play(game, 600);
+	stringstream buffer;
+	bench.run("serializer/game_state", [&](){
+		buffer.seekp(0);
+		game.serialize(buffer);
+		buffer.seekg(0);
+		game.load(buffer);
+	});
+}
+
+static void bench_observation(Bench& bench){
+	seed_random(BENCH_SEED);
+	Game game(MazeGeneration::EXPAND_TREE, {
+		Upgrade::Type::GATLING, Upgrade::Type::LASER, Upgrade::Type::BOMB, Upgrade::Type::RC_MISSILE,
+		Upgrade::Type::HOMING_MISSILE, Upgrade::Type::MINES, Upgrade::Type::DEATH_RAY
+	}, 4);
+	play(game, 100);
+
+	ObservationEncoder encoder;
+	vector<float> floats(game.get_tank_states().size() * encoder.get_size());
+	vector<int16_t> int16s(floats.size());
+	bench.run("observation/4_tanks_float", [&](){
+		encoder.encode(game, floats.data());
+		keep(floats[0]);
+	});
+	bench.run("observation/4_tanks_int16", [&](){
+		encoder.encode(game, int16s.data());
+		keep(int16s[0]);
+	});
+}
+
+int main(int argc, char** argv){
+	Bench bench(argc, argv);
+
+	bench_geometry(bench);
+	bench_maze(bench);
+	bench_serialization(bench);
+	bench_observation(bench);
+
+	bench.print(cerr);
+	bench.write_json(cout, "micro");
+	return 0;
+}
@@ -0,0 +1,196 @@
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "macro.h"
+
+using namespace std;
+
+// A run regresses a metric when it is worse than the baseline by more than the relative tolerance
+// and by more than NOISE_SIGMAS standard deviations of the difference between the run means
+#define NOISE_SIGMAS 3
+
+struct GateMetric{
+	const char* name;
+	double (*get)(const MacroResult& result);
+	bool higher_is_better;
+	double tolerance;
+};
+
+static const GateMetric METRICS[] = {
+	{ "ticks_per_second", [](const MacroResult& result){ return result.ticks_per_second; }, true, 0.10 },
+	{ "tick_p50_ns", [](const MacroResult& result){ return (double)result.tick_p50_ns; }, false, 0.10 },
+	{ "tick_p99_ns", [](const MacroResult& result){ return (double)result.tick_p99_ns; }, false, 0.15 },
+	{ "allocations_per_tick", [](const MacroResult& result){ return result.allocations_per_tick; }, false, 0.01 },
+	{ "allocated_bytes_per_tick", [](const MacroResult& result){ return result.allocated_bytes_per_tick; }, false, 0.02 },
+	{ "arena_peak_bytes", [](const MacroResult& result){ return (double)result.arena_peak_bytes; }, false, 0.02 },
+	{ "match_peak_heap_bytes", [](const MacroResult& result){ return (double)result.match_peak_heap_bytes; }, false, 0.02 },
+};
+#define METRIC_COUNT (int)(sizeof(METRICS) / sizeof(METRICS[0]))
+
+struct MetricStats{
+	double mean, stddev;
+};
+
+static MetricStats get_stats(const vector<double>& values){
+	double sum = 0;
+	for(double value: values) sum += value;
+	double mean = sum / values.size();
+
+	double variance = 0;
+	for(double value: values) variance += (value - mean) * (value - mean);
+	if(values.size() > 1) variance /= values.size() - 1;
+
+	return { .mean = mean, .stddev = sqrt(variance) };
+}
+
+// Finds "key": <number> after the given position, only meant for the files this tool writes
+static bool read_number(const string& text, const string& key, size_t& position, double& value){
+	position = text.find("\"" + key + "\"", position);
+	if(position == string::npos) return false;
+	position = text.find(':', position);
+	if(position == string::npos) return false;
+
+	const char* start = text.c_str() + position + 1;
+	char* end;
+	value = strtod(start, &end);
+	if(end == start) return false;
+	position += end - start;
+	return true;
+}
+
+static bool read_baseline(const char* path, MacroOptions& options, int& runs, MetricStats* stats){
+	ifstream input(path);
+	if(!input.is_open()) return false;
+	stringstream buffer;
+	buffer << input.rdbuf();
+	const string text = buffer.str();
+
+	double games, ticks, tanks, seed, run_count;
+	size_t position = 0;
+	if(!read_number(text, "games", position, games)) return false;
+	if(!read_number(text, "ticks", position, ticks)) return false;
+	if(!read_number(text, "tanks", position, tanks)) return false;
+	if(!read_number(text, "seed", position, seed)) return false;
+	if(!read_number(text, "runs", position, run_count)) return false;
+	options = { .games = (int)games, .ticks = (int)ticks, .tanks = (int)tanks, .seed = (unsigned int)seed };
+	runs = run_count;
+
+	for(int i = 0; i < METRIC_COUNT; i++){
+		position = text.find("\"" + string(METRICS[i].name) + "\"");
+		if(position == string::npos) return false;
+		if(!read_number(text, "mean", position, stats[i].mean)) return false;
+		if(!read_number(text, "stddev", position, stats[i].stddev)) return false;
+	}
+	return true;
+}
+
+static bool write_baseline(const char* path, const MacroOptions& options, int runs, const MetricStats* stats){
+	ofstream output(path);
+	if(!output.is_open()) return false;
+
+	output << "{" << endl
+		<< "  \"suite\": \"perf_gate\"," << endl
+		<< "  \"games\": " << options.games << ", \"ticks\": " << options.ticks
+		<< ", \"tanks\": " << options.tanks << ", \"seed\": " << options.seed << ", \"runs\": " << runs << "," << endl
+		<< "  \"metrics\": {";
+	for(int i = 0; i < METRIC_COUNT; i++){
+		output << (i ? "," : "") << endl << fixed << setprecision(3)
+			<< "    \"" << METRICS[i].name << "\": {\"mean\": " << stats[i].mean << ", \"stddev\": " << stats[i].stddev << "}";
+	}
+	output << endl << "  }" << endl << "}" << endl;
+	return output.good();
+}
+
+static void measure(const MacroOptions& options, int runs, MetricStats* stats){
+	// Warms up caches and the allocator before anything is recorded
+	auto warmup = options;
+	warmup.games = 1;
+	run_macro_bench(warmup);
+
+	vector<vector<double>> values(METRIC_COUNT);
+	for(int run = 0; run < runs; run++){
+		const auto result = run_macro_bench(options);
+		for(int i = 0; i < METRIC_COUNT; i++) values[i].push_back(METRICS[i].get(result));
+		cerr << "run " << run + 1 << "/" << runs << ": " << fixed << setprecision(1)
+			<< result.ticks_per_second << " ticks/s, p99 " << result.tick_p99_ns << " ns" << endl;
+	}
+	for(int i = 0; i < METRIC_COUNT; i++) stats[i] = get_stats(values[i]);
+}
+
+// Arguments: [--baseline <path>] [--runs <n>] [--update]
+int main(int argc, char** argv){
+	const char* path = "bench/baseline.json";
+	int runs = 5;
+	bool update = false;
+	for(int i = 1; i < argc; i++){
+		string option = argv[i];
+		if(option == "--update") update = true;
+		else if(i + 1 < argc){
+			if(option == "--baseline") path = argv[i + 1];
+			if(option == "--runs") runs = atoi(argv[i + 1]);
+			i++;
+		}
+	}
+	if(runs < 2) runs = 2;
+
+	MetricStats current[METRIC_COUNT];
+	if(update){
+		auto options = get_default_macro_options();
+		measure(options, runs, current);
+		if(!write_baseline(path, options, runs, current)){
+			cerr << "Error writing baseline " << path << endl;
+			return 2;
+		}
+		cerr << "Baseline written to " << path << endl;
+		return 0;
+	}
+
+	MacroOptions options;
+	int baseline_runs;
+	MetricStats baseline[METRIC_COUNT];
+	if(!read_baseline(path, options, baseline_runs, baseline)){
+		cerr << "Error reading baseline " << path << ", record one with --update" << endl;
+		return 2;
+	}
+	measure(options, runs, current);
+
+	cerr << left << setw(26) << "metric" << right
+		<< setw(16) << "baseline"
+		<< setw(16) << "current"
+		<< setw(10) << "change"
+		<< setw(10) << "limit" << endl;
+
+	int regressions = 0;
+	for(int i = 0; i < METRIC_COUNT; i++){
+		const auto& metric = METRICS[i];
+		double worse_by = metric.higher_is_better ? baseline[i].mean - current[i].mean : current[i].mean - baseline[i].mean;
+		double noise = NOISE_SIGMAS * sqrt(
+			baseline[i].stddev * baseline[i].stddev / baseline_runs +
+			current[i].stddev * current[i].stddev / runs
+		);
+		double limit = max(metric.tolerance * fabs(baseline[i].mean), noise);
+		bool regressed = worse_by > limit;
+		if(regressed) regressions++;
+
+		double change = baseline[i].mean != 0 ? 100 * (current[i].mean - baseline[i].mean) / baseline[i].mean : 0;
+		cerr << left << setw(26) << metric.name << right << fixed << setprecision(1)
+			<< setw(16) << baseline[i].mean
+			<< setw(16) << current[i].mean
+			<< setw(9) << showpos << change << "%" << noshowpos
+			<< setw(9) << (baseline[i].mean != 0 ? 100 * limit / fabs(baseline[i].mean) : 0) << "%"
+			<< (regressed ? "  REGRESSION" : "") << endl;
+	}
+
+	if(regressions){
+		cerr << regressions << " metric(s) regressed against " << path << endl;
+		return 1;
+	}
+	cerr << "No regressions against " << path << endl;
+	return 0;
+}
@@ -0,0 +1,780 @@
+#include "reference.h"
+
+#include <set>
+#include <deque>
+#include <algorithm>
+#include <functional>
+#include <math.h>
+
+using namespace std;
+
+// Kept as they were before the optimizations, only renamed and moved here.
+// The test for circles moving along an edge was inverted, it is fixed here as well.
+
+static inline vector<Point> get_maze_rect(int left, int right, int top, int bottom){
+	return {
+		{ .x = right + WALL_WIDTH, .y = top - WALL_WIDTH },
+		{ .x = right + WALL_WIDTH, .y = bottom + WALL_WIDTH },
+		{ .x = left - WALL_WIDTH, .y = bottom + WALL_WIDTH },
+		{ .x = left - WALL_WIDTH, .y = top - WALL_WIDTH },
+	};
+}
+
+vector<vector<Point>> reference_get_maze_polygons(int x, int y, const Maze& maze){
+	vector<vector<Point>> polygons;
+
+	if(maze.has_hwall_below(x, y)){
+		polygons.push_back(get_maze_rect(
+			x - (maze.has_hwall_below(x - 1, y) ? 1 : 0),
+			x + (maze.has_hwall_below(x + 1, y) ? 2 : 1),
+			y + 1, y + 2
+		));
+	}
+	if(maze.has_hwall_below(x, y - 1)){
+		polygons.push_back(get_maze_rect(
+			x - (maze.has_hwall_below(x - 1, y - 1) ? 1 : 0),
+			x + (maze.has_hwall_below(x + 1, y - 1) ? 2 : 1),
+			y - 1, y
+		));
+	}
+	if(maze.has_vwall_right(x, y)){
+		polygons.push_back(get_maze_rect(
+			x + 1, x + 2,
+			y - (maze.has_vwall_right(x, y - 1) ? 1 : 0),
+			y + (maze.has_vwall_right(x, y + 1) ? 2 : 1)
+		));
+	}
+	if(maze.has_vwall_right(x - 1, y)){
+		polygons.push_back(get_maze_rect(
+			x - 1, x,
+			y - (maze.has_vwall_right(x - 1, y - 1) ? 1 : 0),
+			y + (maze.has_vwall_right(x - 1, y + 1) ? 2 : 1)
+		));
+	}
+
+	if(!(maze.has_hwall_below(x, y) || maze.has_vwall_right(x, y))){
+		auto hwall = maze.has_hwall_below(x + 1, y), vwall = maze.has_vwall_right(x, y + 1);
+		if(hwall || vwall) polygons.push_back(get_maze_rect(
+			x + 1, x + (hwall ? 2 : 1),
+			y + 1, y + (vwall ? 2 : 1)
+		));
+	}
+	if(!(maze.has_hwall_below(x, y - 1) || maze.has_vwall_right(x, y))){
+		auto hwall = maze.has_hwall_below(x + 1, y - 1), vwall = maze.has_vwall_right(x, y - 1);
+		if(hwall || vwall) polygons.push_back(get_maze_rect(
+			x + 1, x + (hwall ? 2 : 1),
+			y - (vwall ? 1 : 0), y
+		));
+	}
+	if(!(maze.has_hwall_below(x, y - 1) || maze.has_vwall_right(x - 1, y))){
+		auto hwall = maze.has_hwall_below(x - 1, y - 1), vwall = maze.has_vwall_right(x - 1, y - 1);
+		if(hwall || vwall) polygons.push_back(get_maze_rect(
+			x - (hwall ? 1 : 0), x,
+			y - (vwall ? 1 : 0), y
+		));
+	}
+	if(!(maze.has_hwall_below(x, y) || maze.has_vwall_right(x - 1, y))){
+		auto hwall = maze.has_hwall_below(x - 1, y), vwall = maze.has_vwall_right(x - 1, y + 1);
+		if(hwall || vwall) polygons.push_back(get_maze_rect(
+			x - (hwall ? 1 : 0), x,
+			y + 1, y + (vwall ? 2 : 1)
+		));
+	}
+	return polygons;
+}
+
+vector<Point> reference_get_rotated_rectangle(
+	const Point& center,
+	const Point& direction, 
+	Number width, Number length
+){
+	Point normal = { .x = direction.y, .y = -direction.x };
+	return {
+		center + ((direction * length) + (normal * width)) / 2,
+		center + ((direction * length) - (normal * width)) / 2,
+		center - ((direction * length) + (normal * width)) / 2,
+		center - ((direction * length) - (normal * width)) / 2
+	};
+}
+
+vector<Collision> reference_get_tank_collisions(const TankState& tank, const Maze& maze){
+	vector<Collision> collisions;
+
+	const auto rect = reference_get_rotated_rectangle(
+		tank.position,
+		tank.direction,
+		TANK_WIDTH, TANK_LENGTH
+	);
+
+	for(const auto& wall: reference_get_maze_polygons(tank.position.x, tank.position.y, maze)){
+		Collision collision = {
+			.position = { .x = 0, .y = 0 },
+			.normal = { .x = 0, .y = 0 },
+			.depth = 0
+		};
+		if(reference_polygon_collision(rect, wall, collision)){
+			collisions.push_back(collision);
+		}
+	}
+
+	return collisions;
+}
+
+bool reference_polygon_collision(
+	const vector<Point>& polygon1,
+	const vector<Point>& polygon2,
+	Collision& collision
+){
+	auto edge1 = polygon1[1] - polygon1[0];
+	normalize(edge1);
+	
+	int starting_index2 = polygon2.size();
+	while(cross(
+		edge1,
+		polygon2[(starting_index2 + 1) % polygon2.size()] - polygon2[starting_index2 % polygon2.size()]
+	) > 0) starting_index2 ++;  // next polygon2 edge is going closer
+	while(cross(
+		edge1,
+		polygon2[(starting_index2 - 1) % polygon2.size()] - polygon2[starting_index2 % polygon2.size()]
+	) > 0) starting_index2 --;  // previous polygon2 edge is going farther
+	
+	bool first = true;
+	auto edge2 = polygon2[(starting_index2 + 1) % polygon2.size()] - polygon2[starting_index2 % polygon2.size()];	
+
+	normalize(edge2);
+	for(
+		int index1 = 0, index2 = starting_index2;
+		index1 < polygon1.size() || index2 < starting_index2 + polygon2.size();
+	){
+		if(cross(edge1, edge2) > 0){
+			Number current_depth = cross(
+				edge2,
+				polygon1[index1 % polygon1.size()] - polygon2[index2 % polygon2.size()]
+			);
+			if(current_depth < 0) return false;
+			if(first || current_depth < collision.depth){
+				first = false;
+				collision.depth = current_depth;
+				collision.normal = {
+					.x = -edge2.y,
+					.y = edge2.x
+				};
+				collision.position = polygon1[index1 % polygon1.size()];
+			}
+			index2 += 1;
+			
+			edge2 = polygon2[(index2 + 1) % polygon2.size()] - polygon2[index2 % polygon2.size()];
+			normalize(edge2);
+		} else {
+			Number current_depth = cross(
+				edge1,
+				polygon2[index2 % polygon1.size()] - polygon1[index1 % polygon1.size()]
+			);
+			if(current_depth < 0) return false;
+			if(first || current_depth < collision.depth){
+				first = false;
+				collision.depth = current_depth;
+				collision.normal = {
+					.x = edge1.y,
+					.y = -edge1.x
+				};
+				collision.position = polygon2[index2 % polygon1.size()];
+			}
+			index1 += 1;
+			
+			edge1 = polygon1[(index1 + 1) % polygon1.size()] - polygon1[index1 % polygon1.size()];
+			normalize(edge1);
+		}
+	}
+	
+	return true;
+}
+
+bool reference_polygon_moving_circle_collision(
+	const vector<Point>& polygon,
+	const Point& position,
+	const Point& velocity,
+	Number radius,
+	Point& normal,
+	Number& fraction
+) {
+	
+	Number max_fraction = 1, min_fraction = 0;
+	
+	for(int i = 0; i < polygon.size(); i++){
+		Point edge = polygon[(i + 1) % polygon.size()] - polygon[i];
+		normalize(edge);
+		
+		auto slope = cross(velocity, edge);
+		auto intersect = (radius - cross(position - polygon[i], edge));
+		
+		if(slope == 0){
+			if(intersect < 0) min_fraction = max_fraction + 1;  // Moving along the edge, outside of it
+		}
+		else{
+			auto candidate = intersect / slope;
+			if(slope > 0){
+				if(candidate < max_fraction){
+					max_fraction = candidate;
+				}
+			} else if(slope < 0){
+				if(candidate > min_fraction){
+					min_fraction = candidate;
+					normal = { .x = edge.y, .y = -edge.x };
+				}
+			}
+		}
+		
+		Point next_edge = polygon[(i + 2) % polygon.size()] - polygon[(i + 1) % polygon.size()];
+		normalize(next_edge);
+		
+		edge += next_edge;
+		Number distance = radius * length(edge);
+		normalize(edge);
+		
+		slope = cross(velocity, edge);
+		intersect = (distance - cross(position - polygon[(i + 1) % polygon.size()], edge));
+		
+		if(slope == 0){
+			if(intersect < 0) min_fraction = max_fraction + 1;
+		}
+		else{
+			auto candidate = intersect / slope;
+			if(slope > 0){
+				if(candidate < max_fraction){
+					max_fraction = candidate;
+				}
+			} else {
+				if(candidate > min_fraction){
+					min_fraction = candidate;
+					normal = { .x = edge.y, .y = -edge.x };
+				}
+			}
+		}
+	}
+	
+	fraction = min_fraction;
+	bool collision = max_fraction > min_fraction;
+	
+	for(const auto& vertex: polygon){
+		Point relative_position = position - vertex;
+		Number slope = dot(relative_position, velocity);
+		Number curve = dot(velocity, velocity);
+		Number discriminant = slope.square() - curve * (dot(relative_position, relative_position) - radius.square());
+
+		if((double)radius >= length(relative_position)){
+			fraction = 0;
+			collision = true;
+			normal = relative_position;
+			normalize(normal);
+			break;  // Already inside
+		}
+		if(curve + radius < dot(relative_position, relative_position)){
+			continue;  // To far
+		}
+		if(slope >= 0){
+			continue;  // Going away
+		}
+		if(curve == 0) continue;
+		
+		if(discriminant < 0){
+			continue;
+		}
+		
+		Number lower = (-slope - sqrt((double)discriminant)) / curve;
+		Number upper = (-slope + sqrt((double)discriminant)) / curve;
+		
+		if(lower < 0) lower = 0;
+		if(upper > 0 && lower < (collision ? fraction : Number(1))){
+			fraction = lower;
+			collision = true;
+			normal = position + velocity * fraction - vertex;
+			normalize(normal);
+		}
+	}
+	
+	return collision;
+}
+
+static Point simple_collision_displacement(const Collision& collision1, const Collision& collision2){
+	return Point({
+		.x = collision1.depth * collision2.normal.y - collision2.depth * collision1.normal.y,
+		.y = collision2.depth * collision1.normal.x - collision1.depth * collision2.normal.x
+	}) / cross(collision1.normal, collision2.normal);
+}
+
+bool reference_get_collision_displacement(const vector<Collision>& collisions, Point& displacement){
+	if(collisions.empty()) return false;
+
+	const Collision* main = nullptr;
+	set<const Collision*, function<bool(const Collision*, const Collision*)>> constraints([&](const Collision* collision1, const Collision* collision2){
+		return dot(main->normal, collision1->normal) > dot(main->normal, collision2->normal);
+	});
+	for(const auto& collision: collisions){
+		if(main == nullptr) main = &collision;
+		else constraints.insert(&collision);
+	}
+
+	deque<const Collision*> left_collisions, right_collisions;
+	deque<Point> left_points, right_points;
+	bool using_main = true;
+	for(auto collision: constraints){
+		auto side = cross(main->normal, collision->normal);
+		if(side == 0) return false;
+
+		deque<const Collision*>& current = side > 0 ? right_collisions : left_collisions;
+		deque<const Collision*>& other = side > 0 ? left_collisions : right_collisions;
+		deque<Point>& current_points = side > 0 ? right_points : left_points;
+		deque<Point>& other_points = side > 0 ? left_points : right_points;
+		if(side > 0){
+			if(left_collisions.size() > 0 && cross(left_collisions.back()->normal, collision->normal) <= 0) return false;
+		}
+		else{
+			if(right_collisions.size() > 0 && cross(right_collisions.back()->normal, collision->normal) >= 0) return false;
+		}
+
+		while(current.size() > 0 && dot(collision->normal, current_points.back()) < collision->depth){
+			current.pop_back();
+			current_points.pop_back();
+		}
+		if(current.empty()){
+			if(!using_main) other_points.pop_front();
+			while(other_points.size() > 0 && dot(collision->normal, other_points.front()) < collision->depth){
+				other_points.pop_front();
+				if(using_main) using_main = false;
+				else other.pop_front();
+			}
+
+			if(using_main){
+				current_points.push_back(simple_collision_displacement(*main, *collision));
+			}
+			else{
+				current_points.push_back(simple_collision_displacement(*other.front(), *collision));
+				other_points.push_front(current_points.back());
+			}
+		}
+		else{
+			current_points.push_back(simple_collision_displacement(*current.back(), *collision));
+		}
+		current.push_back(collision);
+	}
+
+	if(!using_main) {
+		main = left_collisions.front();
+		left_collisions.pop_front();
+		left_points.pop_front();
+	}
+	displacement = main->normal * main->depth;
+	while(left_collisions.size() > 0 && dot(displacement, left_collisions.front()->normal) < left_collisions.front()->depth){
+		displacement = left_collisions.front()->normal * left_collisions.front()->depth;
+		if(dot(displacement, main->normal) < main->depth){
+			displacement = left_points.front();
+			return true;
+		}
+		main = left_collisions.front();
+		left_collisions.pop_front();
+		left_points.pop_front();
+	}
+	while(right_collisions.size() > 0 && dot(displacement, right_collisions.front()->normal) < right_collisions.front()->depth){
+		displacement = right_collisions.front()->normal * right_collisions.front()->depth;
+		if(dot(displacement, main->normal) < main->depth){
+			displacement = right_points.front();
+			return true;
+		}
+		main = right_collisions.front();
+		right_collisions.pop_front();
+		right_points.pop_front();
+	}
+	return true;
+}
+
+static const Number EPSILON = Number(1) / 10000;
+
+// The turns onto the discrete headings and collision_rotate are shared with the game,
+// only the contacts and the displacement are the reference ones
+void reference_advance_tank(TankState& tank, const Maze& maze){
+	int turn_state = (tank.key_state.right ? 1 : 0) - (tank.key_state.left ? 1 : 0);
+
+	if(turn_state){
+		Point previous_direction = tank.direction;
+		int previous_heading = tank.heading;
+		Point previous_position = tank.position;
+		
+		if(tank.heading >= 0){
+			tank.heading = turn_heading(tank.heading, turn_state);
+			tank.direction = get_heading_direction(tank.heading);
+		}
+		else{
+			tank.direction = rotate(
+				tank.direction,
+				{ .x = TURN_COS, .y = turn_state * TURN_SIN }
+			);
+			normalize(tank.direction);
+		}
+
+		auto collisions = reference_get_tank_collisions(tank, maze);
+		if(!collisions.empty()){
+			Point displacement = { .x = 0, .y = 0 };
+			for(auto& collision: collisions) collision.depth += EPSILON;
+
+			if(reference_get_collision_displacement(collisions, displacement)){
+				tank.position -= displacement;
+				collisions = reference_get_tank_collisions(tank, maze);
+			}
+		}
+		if(!collisions.empty()){
+			tank.direction = previous_direction;
+			tank.heading = previous_heading;
+			tank.position = previous_position;
+		}
+	}
+
+
+	Number speed = (
+		tank.key_state.forward ? TANK_SPEED : Number(0)
+	) - (
+		tank.key_state.back ? TANK_REVERSE_SPEED : Number(0)
+	);
+
+	if(speed != 0){
+		Point previous_direction = tank.direction;
+		int previous_heading = tank.heading;
+		Point previous_position = tank.position;
+		
+		tank.position += tank.direction * speed;
+
+		auto collisions = reference_get_tank_collisions(tank, maze);
+		if(!collisions.empty()){
+			for(auto& collision: collisions) collision.depth += EPSILON;
+
+			Point rotated = tank.direction;
+			if(collision_rotate(collisions, tank.position, rotated, 2*TURN_SIN)){
+				normalize(rotated);
+				if(tank.heading >= 0){
+					tank.heading = turn_heading(tank.heading, get_heading_turn(tank.direction, rotated));
+					tank.direction = get_heading_direction(tank.heading);
+				}
+				else tank.direction = rotated;
+				collisions = reference_get_tank_collisions(tank, maze);
+			}
+		}
+		if(!collisions.empty()){
+			tank.direction = previous_direction;
+			tank.heading = previous_heading;
+			tank.position = previous_position;
+		}
+	}
+}
+
+bool reference_check_death_ray_collision(const vector<Point>& path, const TankState& tank){
+	Point normal = { .x = 0, .y = 0 };
+	Number fraction = 0;
+	for(int i = 1; i < path.size(); i++){
+		if(reference_polygon_moving_circle_collision(
+			reference_get_rotated_rectangle(
+				tank.position, tank.direction,
+				TANK_WIDTH, TANK_LENGTH
+			),
+			path[i-1], path[i] - path[i-1],
+			DEATH_RAY_WIDTH,
+			normal, fraction
+		)) return true;
+	}
+	return false;
+}
+
+int reference_advance_shot(
+	ShotDetails& shot,
+	const Maze& maze,
+	const vector<const TankState*>& tanks,
+	int& ignored_tank,
+	vector<TimePoint>& collisions
+){	
+	collisions.push_back({
+		.point = shot.position,
+		.time = 1
+	});
+
+	Point remaining_way = shot.velocity;
+
+	int tank_collision = -1;
+
+	bool finished = false;
+
+	while(!finished){
+		Point step = remaining_way;
+		auto len = length(step);
+		if(len < 0.5){
+			finished = true;
+		} else {
+			if( len > 1 ) normalize(step);
+			step /= 2;
+		}
+		
+		Number fraction = 1;
+		Point normal = { .x = 0, .y = 0 };
+		for(const auto& polygon: reference_get_maze_polygons(shot.position.x, shot.position.y, maze)){
+			Number current_fraction = 0;
+			Point current_normal = { .x = 0, .y = 0 };
+			
+			if(reference_polygon_moving_circle_collision(
+				polygon,
+				shot.position, step,
+				shot.radius,
+				current_normal, current_fraction
+			)){
+				if(current_fraction < fraction && (current_normal.x * shot.velocity.x < 0 || current_normal.y * shot.velocity.y < 0)){
+					ignored_tank = -1;
+					finished = false;
+					fraction = current_fraction;
+					normal = current_normal;
+				}
+			}
+		}
+		
+		for(int tank_index = 0; tank_index < tanks.size(); tank_index++){
+			if(!tanks[tank_index]->alive) continue;
+
+			auto polygon = reference_get_rotated_rectangle(
+				tanks[tank_index]->position,
+				tanks[tank_index]->direction,
+				TANK_WIDTH, TANK_LENGTH
+			);
+
+			Number current_fraction = 0;
+			Point current_normal = { .x = 0, .y = 0 };
+			
+			if(reference_polygon_moving_circle_collision(
+				polygon,
+				shot.position, step,
+				shot.radius,
+				current_normal, current_fraction
+			)){
+				if(tank_index != ignored_tank && current_fraction < fraction){
+					finished = true;
+					tank_collision = tank_index;
+					fraction = current_fraction;
+				}
+			}
+		}
+		
+		step *= fraction;
+		shot.position += step;
+		remaining_way -= step;
+		
+		if(tank_collision < 0 && fraction < 1){  // Wall collision
+			if(normal.x * shot.velocity.x < 0){
+				shot.velocity.x = -shot.velocity.x;
+				remaining_way.x = -remaining_way.x;
+			}
+			if(normal.y * shot.velocity.y < 0){
+				shot.velocity.y = -shot.velocity.y;
+				remaining_way.y = -remaining_way.y;
+			}
+			collisions.push_back({
+				.point = shot.position,
+				.time = length(remaining_way) / length(shot.velocity),
+			});
+		}
+	}
+
+	return tank_collision;
+}
+
+Number reference_shrapnel_wall_collision(const ShrapnelDetails& shrapnel, const Maze& maze){
+	int sections = 1 + 2 * length(shrapnel.distance);
+	Point position = shrapnel.start;
+	Point step = shrapnel.distance / sections;
+	for(int i = 0; i < sections; i++, position += step){
+		bool collision = false;
+		Number fraction = 0;
+		for(const auto& polygon: reference_get_maze_polygons(position.x, position.y, maze)){
+			Number current_fraction = 0;
+			Point current_normal = { .x = 0, .y = 0 };
+			
+			if(reference_polygon_moving_circle_collision(
+				polygon,
+				position, step,
+				0,
+				current_normal, current_fraction
+			)){
+				if(!collision || current_fraction < fraction){
+					fraction = current_fraction;
+					collision = true;
+				}
+			}
+		}
+		
+		if(collision) return (fraction + i) / sections;
+	}
+	return 2;
+}
+
+// Every straight run of walls in the maze as the thin line it is, padded by WALL_WIDTH on all sides
+struct OracleWall{
+	double left, right, top, bottom;
+};
+static vector<OracleWall> get_oracle_walls(const Maze& maze){
+	const double wall = (double)WALL_WIDTH;
+	vector<OracleWall> walls;
+	for(int y = -1; y < maze.get_h(); y++){
+		for(int x = 0; x < maze.get_w(); x++){
+			if(!maze.has_hwall_below(x, y)) continue;
+			int start = x;
+			while(x + 1 < maze.get_w() && maze.has_hwall_below(x + 1, y)) x++;
+			walls.push_back({ .left = start - wall, .right = x + 1 + wall, .top = y + 1 - wall, .bottom = y + 1 + wall });
+		}
+	}
+	for(int x = -1; x < maze.get_w(); x++){
+		for(int y = 0; y < maze.get_h(); y++){
+			if(!maze.has_vwall_right(x, y)) continue;
+			int start = y;
+			while(y + 1 < maze.get_h() && maze.has_vwall_right(x, y + 1)) y++;
+			walls.push_back({ .left = x + 1 - wall, .right = x + 1 + wall, .top = start - wall, .bottom = y + 1 + wall });
+		}
+	}
+	return walls;
+}
+
+// Earliest time in (0, fraction) at which a point moving from (x, y) by (dx, dy) enters the box
+static void oracle_box_entry(
+	const OracleWall& box,
+	double x, double y, double dx, double dy,
+	double& fraction, double& normal_x, double& normal_y
+){
+	double enter = -INFINITY, leave = INFINITY, enter_x = 0, enter_y = 0;
+	if(dx == 0){
+		if(x <= box.left || x >= box.right) return;
+	}
+	else{
+		double t1 = (box.left - x) / dx, t2 = (box.right - x) / dx;
+		enter = min(t1, t2);
+		enter_x = dx > 0 ? -1 : 1;
+		leave = max(t1, t2);
+	}
+	if(dy == 0){
+		if(y <= box.top || y >= box.bottom) return;
+	}
+	else{
+		double t1 = (box.top - y) / dy, t2 = (box.bottom - y) / dy;
+		if(min(t1, t2) > enter){
+			enter = min(t1, t2);
+			enter_x = 0;
+			enter_y = dy > 0 ? -1 : 1;
+		}
+		leave = min(leave, max(t1, t2));
+	}
+	if(enter < leave && enter > 0 && enter < fraction){
+		fraction = enter;
+		normal_x = enter_x;
+		normal_y = enter_y;
+	}
+}
+
+int oracle_advance_shot(
+	ShotDetails& shot,
+	const Maze& maze,
+	const vector<const TankState*>& tanks,
+	int& ignored_tank,
+	vector<TimePoint>& collisions
+){
+	const auto walls = get_oracle_walls(maze);
+
+	collisions.push_back({
+		.point = shot.position,
+		.time = 1
+	});
+
+	Point remaining_way = shot.velocity;
+
+	int tank_collision = -1;
+
+	// The game's circles touch a wall when their center enters the wall grown by the radius, corners stay square
+	const double radius = (double)shot.radius;
+	while(true){
+		double wall_fraction = 1, normal_x = 0, normal_y = 0;
+		for(const auto& wall: walls){
+			oracle_box_entry(
+				{ .left = wall.left - radius, .right = wall.right + radius, .top = wall.top - radius, .bottom = wall.bottom + radius },
+				(double)shot.position.x, (double)shot.position.y,
+				(double)remaining_way.x, (double)remaining_way.y,
+				wall_fraction, normal_x, normal_y
+			);
+		}
+		Number fraction = wall_fraction;
+		bool wall_collision = (double)fraction < 1;
+		if(wall_collision) ignored_tank = -1;
+
+		for(int tank_index = 0; tank_index < tanks.size(); tank_index++){
+			if(!tanks[tank_index]->alive) continue;
+
+			Number current_fraction = 0;
+			Point current_normal = { .x = 0, .y = 0 };
+
+			if(reference_polygon_moving_circle_collision(
+				reference_get_rotated_rectangle(
+					tanks[tank_index]->position,
+					tanks[tank_index]->direction,
+					TANK_WIDTH, TANK_LENGTH
+				),
+				shot.position, remaining_way,
+				shot.radius,
+				current_normal, current_fraction
+			)){
+				if(tank_index != ignored_tank && current_fraction < fraction){
+					tank_collision = tank_index;
+					fraction = current_fraction;
+				}
+			}
+		}
+
+		Point step = remaining_way * fraction;
+		shot.position += step;
+		remaining_way -= step;
+
+		if(tank_collision >= 0 || !wall_collision) break;
+
+		if(normal_x * (double)shot.velocity.x < 0){
+			shot.velocity.x = -shot.velocity.x;
+			remaining_way.x = -remaining_way.x;
+		}
+		if(normal_y * (double)shot.velocity.y < 0){
+			shot.velocity.y = -shot.velocity.y;
+			remaining_way.y = -remaining_way.y;
+		}
+		collisions.push_back({
+			.point = shot.position,
+			.time = length(remaining_way) / length(shot.velocity),
+		});
+	}
+
+	return tank_collision;
+}
+
+Number oracle_shrapnel_wall_collision(const ShrapnelDetails& shrapnel, const Maze& maze){
+	double x = (double)shrapnel.start.x, y = (double)shrapnel.start.y;
+	double dx = (double)shrapnel.distance.x, dy = (double)shrapnel.distance.y;
+
+	double fraction = 2;
+	for(const auto& wall: get_oracle_walls(maze)){
+		double enter = 0, leave = 1;
+		if(dx == 0){
+			if(x < wall.left || x > wall.right) continue;
+		}
+		else{
+			double t1 = (wall.left - x) / dx, t2 = (wall.right - x) / dx;
+			enter = max(enter, min(t1, t2));
+			leave = min(leave, max(t1, t2));
+		}
+		if(dy == 0){
+			if(y < wall.top || y > wall.bottom) continue;
+		}
+		else{
+			double t1 = (wall.top - y) / dy, t2 = (wall.bottom - y) / dy;
+			enter = max(enter, min(t1, t2));
+			leave = min(leave, max(t1, t2));
+		}
+		if(enter <= leave) fraction = min(fraction, enter);
+	}
+	return fraction;
+}
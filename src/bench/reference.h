@@ -0,0 +1,61 @@
+#ifndef _REFERENCE_H
+#define _REFERENCE_H
+
+// The collision kernels as they were before the optimizations. Most of the optimized ones in
+// game/logic must reproduce them bit for bit, the shot and shrapnel wall tests changed on purpose
+// and are held to the oracles below instead.
+
+#include <vector>
+
+#include "../game/logic/geometry.h"
+#include "../game/data/game_objects.h"
+
+using namespace std;
+
+vector<vector<Point>> reference_get_maze_polygons(int x, int y, const Maze& maze);
+vector<Point> reference_get_rotated_rectangle(
+	const Point& center,
+	const Point& direction,
+	Number width, Number length
+);
+vector<Collision> reference_get_tank_collisions(const TankState& tank, const Maze& maze);
+
+bool reference_polygon_collision(
+	const vector<Point>& polygon1,
+	const vector<Point>& polygon2,
+	Collision& collision
+);
+bool reference_polygon_moving_circle_collision(
+	const vector<Point>& polygon,
+	const Point& position,
+	const Point& velocity,
+	Number radius,
+	Point& normal,
+	Number& fraction
+);
+bool reference_get_collision_displacement(const vector<Collision>& collisions, Point& displacement);
+void reference_advance_tank(TankState& tank, const Maze& maze);
+
+int reference_advance_shot(
+	ShotDetails& shot,
+	const Maze& maze,
+	const vector<const TankState*>& tanks,
+	int& ignored_tank,
+	vector<TimePoint>& collisions
+);
+Number reference_shrapnel_wall_collision(const ShrapnelDetails& shrapnel, const Maze& maze);
+
+bool reference_check_death_ray_collision(const vector<Point>& path, const TankState& tank);
+
+// Exact oracles for the shot and shrapnel wall tests: they try every wall of the maze
+// as a thin line padded by WALL_WIDTH, instead of the walls around the cells crossed
+int oracle_advance_shot(
+	ShotDetails& shot,
+	const Maze& maze,
+	const vector<const TankState*>& tanks,
+	int& ignored_tank,
+	vector<TimePoint>& collisions
+);
+Number oracle_shrapnel_wall_collision(const ShrapnelDetails& shrapnel, const Maze& maze);
+
+#endif
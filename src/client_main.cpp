@@ -5,6 +5,8 @@
 #include "gui/game/game_gui.h"
 #include "gui/controls/keyset.h"
 #include "game/logic/game.h"
+#include "game/replay/replay.h"
+#include "utils/trace.h"
 
 using namespace std;
 
@@ -39,7 +41,7 @@ int main(int argc, char** argv){
 	}
 	atexit(close_window);
 	
-	renderer = SDL_CreateRenderer(screen, -1,SDL_RENDERER_TARGETTEXTURE);
+	renderer = SDL_CreateRenderer(screen, -1, SDL_RENDERER_TARGETTEXTURE | SDL_RENDERER_PRESENTVSYNC);
 	if(renderer == NULL){
 		cerr << "Error while opening renderer:" << endl << SDL_GetError() << endl;
 		return 3;
@@ -87,14 +89,43 @@ int main(int argc, char** argv){
 	));
 	game.get_player_interface(2).set_active(false);
 	
-	GameGui gui(
-		&game,
-		&game,
-		settings,
-		move(controllers)
-	);
+	unique_ptr<ReplayWriter> replay_writer = nullptr;
+#ifdef TRACING
+	const char* trace_path = nullptr;
+#endif
+	for(int i = 1; i + 1 < argc; i += 2){
+		if(string(argv[i]) == "--record"){
+			replay_writer = make_unique<ReplayWriter>(argv[i + 1], game);
+			if(!replay_writer->is_open()){
+				cerr << "Error while opening replay file:" << endl << argv[i + 1] << endl;
+				return 4;
+			}
+		}
+#ifdef TRACING
+		if(string(argv[i]) == "--trace"){
+			trace_path = argv[i + 1];
+			TRACE_THREAD_NAME("render");
+			enable_tracing(true);
+		}
+#endif
+	}
+	
+	{
+		GameGui gui(
+			&game,
+			&game,
+			settings,
+			move(controllers)
+		);
 
-	mainloop(gui, renderer);
+		mainloop(gui, renderer);
+	}
+
+#ifdef TRACING
+	if(trace_path != nullptr && !write_trace(trace_path)){
+		cerr << "Error while writing trace file:" << endl << trace_path << endl;
+	}
+#endif
 	
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,160 @@
+#include "game_batch.h"
+
+#include "../../utils/utils.h"
+
+GameBatch::GameBatch(
+	int game_num, int tank_num,
+	MazeGeneration maze_generation,
+	const set<Upgrade::Type>& allowed_upgrades,
+	unsigned int seed,
+	int thread_num,
+	const ObservationLayout& layout
+) :
+	maze_generation(maze_generation),
+	allowed_upgrades(allowed_upgrades),
+	tank_num(tank_num),
+	encoder(layout),
+	slots(game_num),
+	keys(nullptr),
+	observations(nullptr),
+	int16_observations(nullptr),
+	results(nullptr),
+	work_generation(0),
+	busy_workers(0),
+	stopping(false) {
+
+	seed_seq seeds = { seed };
+	vector<unsigned int> game_seeds(game_num);
+	seeds.generate(game_seeds.begin(), game_seeds.end());
+
+	for(int i = 0; i < game_num; i++){
+		slots[i].random.seed(game_seeds[i]);
+		use_random_engine(&slots[i].random);
+		slots[i].game = make_unique<Game>(maze_generation, allowed_upgrades, tank_num);
+	}
+	use_random_engine(nullptr);
+
+	for(int i = 1; i < thread_num && i < game_num; i++){
+		workers.push_back(thread(&GameBatch::work, this, i));
+	}
+}
+
+GameBatch::~GameBatch(){
+	{
+		lock_guard<mutex> lock(work_mutex);
+		stopping = true;
+	}
+	work_ready.notify_all();
+	for(auto& worker: workers) worker.join();
+}
+
+int GameBatch::get_game_num() const{
+	return slots.size();
+}
+int GameBatch::get_tank_num() const{
+	return tank_num;
+}
+int GameBatch::get_observation_size() const{
+	return tank_num * encoder.get_size();
+}
+const ObservationEncoder& GameBatch::get_encoder() const{
+	return encoder;
+}
+const Game& GameBatch::get_game(int index) const{
+	return *slots[index].game;
+}
+
+void GameBatch::step_game(int index){
+	Slot& slot = slots[index];
+	use_random_engine(&slot.random);
+
+	slot.game->advance_with(Span<KeyState>(keys + index * tank_num, tank_num));
+
+	// Like a match, a round ends with at most one tank left
+	const auto& tanks = slot.game->get_tank_states();
+	int alive = 0, survivor = BATCH_ROUND_DRAW;
+	for(int i = 0; i < tanks.size(); i++){
+		if(!tanks[i]->alive) continue;
+		alive++;
+		survivor = i;
+	}
+	int result = BATCH_ROUND_RUNNING;
+	if(alive < min(tank_num, 2)){
+		result = alive == 0 ? BATCH_ROUND_DRAW : survivor;
+		slot.game = make_unique<Game>(maze_generation, allowed_upgrades, tank_num);
+	}
+
+	use_random_engine(nullptr);
+
+	if(results != nullptr) results[index] = result;
+	if(observations != nullptr) encoder.encode(*slot.game, observations + index * get_observation_size());
+	if(int16_observations != nullptr) encoder.encode(*slot.game, int16_observations + index * get_observation_size());
+}
+
+// Every worker steps a contiguous share of the games, the calling thread being worker 0
+void GameBatch::run_share(int worker){
+	int worker_num = workers.size() + 1;
+	int begin = (long long)slots.size() * worker / worker_num;
+	int end = (long long)slots.size() * (worker + 1) / worker_num;
+	for(int i = begin; i < end; i++) step_game(i);
+}
+
+void GameBatch::work(int worker){
+	int generation = 0;
+	while(true){
+		{
+			unique_lock<mutex> lock(work_mutex);
+			work_ready.wait(lock, [&](){ return stopping || work_generation != generation; });
+			if(stopping) return;
+			generation = work_generation;
+		}
+
+		run_share(worker);
+
+		{
+			lock_guard<mutex> lock(work_mutex);
+			busy_workers--;
+		}
+		work_done.notify_one();
+	}
+}
+
+void GameBatch::run_step(){
+	if(!workers.empty()){
+		{
+			lock_guard<mutex> lock(work_mutex);
+			busy_workers = workers.size();
+			work_generation++;
+		}
+		work_ready.notify_all();
+	}
+
+	run_share(0);
+
+	if(!workers.empty()){
+		unique_lock<mutex> lock(work_mutex);
+		work_done.wait(lock, [&](){ return busy_workers == 0; });
+	}
+}
+
+void GameBatch::step(const KeyState* keys, float* observations, int* results){
+	this->keys = keys;
+	this->observations = observations;
+	this->int16_observations = nullptr;
+	this->results = results;
+	run_step();
+}
+void GameBatch::step(const KeyState* keys, int16_t* observations, int* results){
+	this->keys = keys;
+	this->observations = nullptr;
+	this->int16_observations = observations;
+	this->results = results;
+	run_step();
+}
+
+void GameBatch::observe(float* observations) const{
+	for(int i = 0; i < slots.size(); i++) encoder.encode(*slots[i].game, observations + i * get_observation_size());
+}
+void GameBatch::observe(int16_t* observations) const{
+	for(int i = 0; i < slots.size(); i++) encoder.encode(*slots[i].game, observations + i * get_observation_size());
+}
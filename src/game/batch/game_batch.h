@@ -0,0 +1,86 @@
+#ifndef _GAME_BATCH_H
+#define _GAME_BATCH_H
+
+#include "observation_encoder.h"
+
+#include "../logic/game.h"
+
+#include <memory>
+#include <vector>
+#include <set>
+#include <random>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+using namespace std;
+
+// Written for every game: the round goes on, or it ended without survivors, otherwise the survivor's index
+#define BATCH_ROUND_RUNNING -2
+#define BATCH_ROUND_DRAW -1
+
+// Steps many independent games in lockstep, for training bots.
+// Every game draws from its own random engine, so the results don't depend on the number of threads,
+// and a round that ends is replaced by a new one within the same step.
+class GameBatch{
+	struct Slot{
+		unique_ptr<Game> game;
+		default_random_engine random;
+	};
+
+	const MazeGeneration maze_generation;
+	const set<Upgrade::Type> allowed_upgrades;
+	const int tank_num;
+	const ObservationEncoder encoder;
+	vector<Slot> slots;
+
+	// Arguments of the step in progress, shared with the workers
+	const KeyState* keys;
+	float* observations;
+	int16_t* int16_observations;
+	int* results;
+
+	vector<thread> workers;
+	mutex work_mutex;
+	condition_variable work_ready, work_done;
+	int work_generation, busy_workers;
+	bool stopping;
+
+	void step_game(int index);
+	void run_share(int worker);
+	void run_step();
+	void work(int worker);
+public:
+	GameBatch(
+		int game_num, int tank_num,
+		MazeGeneration maze_generation,
+		const set<Upgrade::Type>& allowed_upgrades,
+		unsigned int seed,
+		int thread_num = 1,
+		const ObservationLayout& layout = ObservationLayout()
+	);
+
+	GameBatch(GameBatch&&) = delete;
+	GameBatch(const GameBatch&) = delete;
+
+	~GameBatch();
+
+	GameBatch& operator=(GameBatch&&) = delete;
+	GameBatch& operator=(const GameBatch&) = delete;
+
+	int get_game_num() const;
+	int get_tank_num() const;
+	int get_observation_size() const;  // Values per game, encoded for one tank after the other
+	const ObservationEncoder& get_encoder() const;
+	const Game& get_game(int index) const;
+
+	// keys holds tank_num key states per game, game after game.
+	// observations receives get_observation_size() values per game, results one value per game,
+	// either may be nullptr.
+	void step(const KeyState* keys, float* observations, int* results);
+	void step(const KeyState* keys, int16_t* observations, int* results);
+	void observe(float* observations) const;
+	void observe(int16_t* observations) const;
+};
+
+#endif
@@ -0,0 +1,173 @@
+#include "observation_encoder.h"
+
+#include <limits>
+
+template<typename T>
+static T convert(double value);
+
+template<>
+float convert<float>(double value){
+	return value;
+}
+template<>
+int16_t convert<int16_t>(double value){
+	double scaled = value * OBSERVATION_INT16_SCALE;
+	if(scaled <= numeric_limits<int16_t>::min()) return numeric_limits<int16_t>::min();
+	if(scaled >= numeric_limits<int16_t>::max()) return numeric_limits<int16_t>::max();
+	return scaled < 0 ? scaled - 0.5 : scaled + 0.5;
+}
+
+// Picks objects nearest first without sorting or storage: every call returns the nearest one
+// after the previous pick in (distance, index) order, or -1, skipping those without a position
+template<typename T, typename GetPosition>
+static int next_nearest(
+	Span<T> objects, double x, double y, GetPosition get_position,
+	double& distance, int previous
+){
+	int result = -1;
+	double result_distance = 0;
+	for(int i = 0; i < objects.size(); i++){
+		const Point* position = get_position(objects[i], i);
+		if(position == nullptr) continue;
+
+		double dx = (double)position->x - x, dy = (double)position->y - y;
+		double current = dx * dx + dy * dy;
+		if(previous != -1 && (current < distance || (current == distance && i <= previous))) continue;
+		if(result != -1 && current >= result_distance) continue;
+		result = i;
+		result_distance = current;
+	}
+	distance = result_distance;
+	return result;
+}
+
+ObservationEncoder::ObservationEncoder(const ObservationLayout& layout) : layout(layout) {}
+
+const ObservationLayout& ObservationEncoder::get_layout() const{
+	return layout;
+}
+
+int ObservationEncoder::get_size() const{
+	int wall_side = 2 * layout.wall_radius + 1;
+	return OBSERVATION_OWN_SIZE +
+		layout.tanks * OBSERVATION_TANK_SIZE +
+		layout.shots * OBSERVATION_SHOT_SIZE +
+		layout.missiles * OBSERVATION_MISSILE_SIZE +
+		wall_side * wall_side * OBSERVATION_CELL_SIZE;
+}
+
+template<typename T>
+void ObservationEncoder::encode_values(const Game& game, T* output) const{
+	const Maze& maze = game.get_maze();
+	const MazeMap& maze_map = game.get_maze_map();
+	const auto tanks = game.get_states();
+	const auto shots = game.get_shots();
+	const auto missiles = game.get_missiles();
+
+	auto put = [&](double value){
+		*output++ = convert<T>(value);
+	};
+	const T wall = convert<T>(1);
+	auto skip = [&](int count){
+		for(int i = 0; i < count; i++) *output++ = 0;
+	};
+
+	for(int index = 0; index < tanks.size(); index++){
+		const TankState& own = tanks[index].state;
+		const double x = own.position.x, y = own.position.y;
+		const int cell_x = own.position.x, cell_y = own.position.y;
+
+		put(x);
+		put(y);
+		put(own.direction.x);
+		put(own.direction.y);
+		put(own.alive);
+		put(tanks[index].upgrade != nullptr ? (int)tanks[index].upgrade->type + 1 : 0);
+
+		double distance = 0;
+		int nearest = -1;
+		for(int i = 0; i < layout.tanks; i++){
+			nearest = next_nearest(tanks, x, y, [&](const TankCompleteState& tank, int other){
+				return other != index && tank.state.alive ? &tank.state.position : nullptr;
+			}, distance, nearest);
+			if(nearest == -1){
+				skip((layout.tanks - i) * OBSERVATION_TANK_SIZE);
+				break;
+			}
+
+			const TankCompleteState& tank = tanks[nearest];
+			const Direction& route = maze_map.get_direction(
+				cell_x, cell_y,
+				tank.state.position.x, tank.state.position.y
+			);
+			put(1);
+			put((double)tank.state.position.x - x);
+			put((double)tank.state.position.y - y);
+			put(tank.state.direction.x);
+			put(tank.state.direction.y);
+			put(tank.upgrade != nullptr ? (int)tank.upgrade->type + 1 : 0);
+			put(route.distance);
+			put(route.dx);
+			put(route.dy);
+		}
+
+		nearest = -1;
+		for(int i = 0; i < layout.shots; i++){
+			nearest = next_nearest(shots, x, y, [](const ShotPath& shot, int){
+				return &shot.state.position;
+			}, distance, nearest);
+			if(nearest == -1){
+				skip((layout.shots - i) * OBSERVATION_SHOT_SIZE);
+				break;
+			}
+
+			const ShotDetails& shot = shots[nearest].state;
+			put(1);
+			put((double)shot.position.x - x);
+			put((double)shot.position.y - y);
+			put(shot.velocity.x);
+			put(shot.velocity.y);
+			put(shot.owner == index);
+		}
+
+		nearest = -1;
+		for(int i = 0; i < layout.missiles; i++){
+			nearest = next_nearest(missiles, x, y, [](const MissileState& missile, int){
+				return &missile.state.position;
+			}, distance, nearest);
+			if(nearest == -1){
+				skip((layout.missiles - i) * OBSERVATION_MISSILE_SIZE);
+				break;
+			}
+
+			const MissileState& missile = missiles[nearest];
+			put(1);
+			put((double)missile.state.position.x - x);
+			put((double)missile.state.position.y - y);
+			put(missile.state.direction.x);
+			put(missile.state.direction.y);
+			put(missile.state.owner == index);
+			put(missile.target == index);
+		}
+
+		// Walls shared with the cells above and on the left are copied from what was written for them
+		const int side = 2 * layout.wall_radius + 1;
+		for(int row = 0; row < side; row++){
+			for(int column = 0; column < side; column++){
+				int wall_x = cell_x - layout.wall_radius + column, wall_y = cell_y - layout.wall_radius + row;
+				output[0] = row > 0 ? output[1 - side * OBSERVATION_CELL_SIZE] : maze.has_hwall_below(wall_x, wall_y - 1) ? wall : 0;
+				output[1] = maze.has_hwall_below(wall_x, wall_y) ? wall : 0;
+				output[2] = column > 0 ? output[3 - OBSERVATION_CELL_SIZE] : maze.has_vwall_right(wall_x - 1, wall_y) ? wall : 0;
+				output[3] = maze.has_vwall_right(wall_x, wall_y) ? wall : 0;
+				output += OBSERVATION_CELL_SIZE;
+			}
+		}
+	}
+}
+
+void ObservationEncoder::encode(const Game& game, float* output) const{
+	encode_values(game, output);
+}
+void ObservationEncoder::encode(const Game& game, int16_t* output) const{
+	encode_values(game, output);
+}
@@ -0,0 +1,55 @@
+#ifndef _OBSERVATION_ENCODER_H
+#define _OBSERVATION_ENCODER_H
+
+#include "../logic/game.h"
+
+#include <cstdint>
+
+using namespace std;
+
+// Values per entry of every part of an observation
+#define OBSERVATION_OWN_SIZE 6
+#define OBSERVATION_TANK_SIZE 9
+#define OBSERVATION_SHOT_SIZE 6
+#define OBSERVATION_MISSILE_SIZE 7
+#define OBSERVATION_CELL_SIZE 4
+
+// Fixed point int16 observations hold value * OBSERVATION_INT16_SCALE, saturated, which keeps
+// 1/128 of a cell of precision and every route distance of a 12x12 maze
+#define OBSERVATION_INT16_SCALE 128
+
+// How many of the nearest objects of each kind an observation holds, and how far around the tank
+// walls are reported, in cells on each side
+struct ObservationLayout{
+	int tanks = 3;
+	int shots = 8;
+	int missiles = 2;
+	int wall_radius = 2;
+};
+
+// Writes what every tank of a game sees into a flat buffer with a fixed layout, tank after tank,
+// without allocating. Positions and distances are in cells, offsets are taken from the observing tank.
+//   own tank: position x and y, direction x and y, alive, upgrade type + 1 or 0
+//   other living tanks: present, offset x and y, direction x and y, upgrade type + 1 or 0,
+//     route distance and first step x and y of the shortest route towards them
+//   shots: present, offset x and y, velocity x and y, fired by this tank
+//   missiles: present, offset x and y, direction x and y, fired by this tank, chasing this tank
+//   walls of the surrounding cells, row after row: above, below, left, right
+// Tanks, shots and missiles are the nearest ones, nearest first, and missing ones leave zeros.
+class ObservationEncoder{
+	const ObservationLayout layout;
+
+	template<typename T>
+	void encode_values(const Game& game, T* output) const;
+public:
+	ObservationEncoder(const ObservationLayout& layout = ObservationLayout());
+
+	const ObservationLayout& get_layout() const;
+	int get_size() const;  // Values per tank
+
+	// Both write get_size() values for every tank of the game
+	void encode(const Game& game, float* output) const;
+	void encode(const Game& game, int16_t* output) const;
+};
+
+#endif
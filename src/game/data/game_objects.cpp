@@ -17,11 +17,11 @@ int Maze::get_h() const{
 
 bool Maze::has_hwall_below(int x, int y) const{
 	if(x < 0 || x >= get_w() || y < 0 || y >= get_h() - 1) return true;
-	return hwalls.at(x).at(y);
+	return hwalls[x][y];
 }
 bool Maze::has_vwall_right(int x, int y) const{
 	if(x < 0 || x >= get_w() - 1 || y < 0 || y >= get_h()) return true;
-	return vwalls.at(x).at(y);
+	return vwalls[x][y];
 }
 
 void Maze::serialize(ostream& output) const{
@@ -34,6 +34,12 @@ Maze Maze::deserialize(istream& input) {
 	
 	return Maze(std::move(hwalls), std::move(vwalls));
 }
+void Maze::hash(StateHash& hash) const{
+	hash.add(get_w());
+	hash.add(get_h());
+	for(const auto& column: hwalls) for(bool wall: column) hash.add(wall);
+	for(const auto& column: vwalls) for(bool wall: column) hash.add(wall);
+}
 
 KeyState::KeyState() : KeyState(false, false, false, false, false) {}
 KeyState::KeyState(
@@ -56,11 +62,13 @@ KeyState KeyState::deserialize(istream& input){
 TankState::TankState(
 	const Point& position,
 	const Point& direction,
+	int heading,
 	const KeyState& key_state,
 	bool active, bool alive
 ) :
 	position(position),
 	direction(direction),
+	heading(heading),
 	key_state(key_state),
 	active(active),
 	alive(alive) {
@@ -70,22 +78,33 @@ TankState::TankState(
 void TankState::serialize(ostream& output) const{
 	serialize_value(output, position);
 	serialize_value(output, direction);
+	serialize_value(output, heading);
 	serialize_value(output, key_state);
 	serialize_flags(output, active, alive);
 }
 TankState TankState::deserialize(istream& input){
 	auto position = deserialize_value<Point>(input);
 	auto direction = deserialize_value<Point>(input);
+	auto heading = deserialize_value<int>(input);
 	auto key_state = deserialize_value<KeyState>(input);
 	auto [active, alive] = deserialize_flags<2>(input);
 	
 	return TankState(
 		position,
 		direction,
+		heading,
 		key_state,
 		active, alive
 	);
 }
+void TankState::hash(StateHash& hash) const{
+	position.hash(hash);
+	direction.hash(hash);
+	hash.add(heading,
+		key_state.left | key_state.right << 1 | key_state.forward << 2 | key_state.back << 3 | key_state.shoot << 4 |
+		active << 5 | alive << 6
+	);
+}
 
 Upgrade::Upgrade(int x, int y, Type type) : x(x), y(y), type(type) {}
 
@@ -101,6 +120,10 @@ Upgrade Upgrade::deserialize(istream& input){
 	
 	return Upgrade(x, y, type);
 }
+void Upgrade::hash(StateHash& hash) const{
+	hash.add(x, y);
+	hash.add(type);
+}
 
 ShotDetails::ShotDetails(
 	const Point& position,
@@ -144,6 +167,13 @@ ShotDetails ShotDetails::deserialize(istream& input){
 		owner
 	);
 }
+void ShotDetails::hash(StateHash& hash) const{
+	position.hash(hash);
+	velocity.hash(hash);
+	radius.hash(hash);
+	hash.add(timer, owner);
+	hash.add(type);
+}
 
 ShrapnelDetails::ShrapnelDetails(
 	const Point& start,
@@ -160,14 +190,20 @@ ShrapnelDetails ShrapnelDetails::deserialize(istream& input){
 	
 	return ShrapnelDetails(start, distance);
 }
+void ShrapnelDetails::hash(StateHash& hash) const{
+	start.hash(hash);
+	distance.hash(hash);
+}
 
 MissileDetails::MissileDetails(
 	const Point& position,
 	const Point& direction,
+	int heading,
 	int owner
 ) :
 	position(position),
 	direction(direction),
+	heading(heading),
 	owner(owner) {
 	
 }
@@ -175,19 +211,27 @@ MissileDetails::MissileDetails(
 void MissileDetails::serialize(ostream& output) const{
 	serialize_value(output, position);
 	serialize_value(output, direction);
+	serialize_value(output, heading);
 	serialize_value(output, owner);
 }
 MissileDetails MissileDetails::deserialize(istream& input){
 	auto position = deserialize_value<Point>(input);
 	auto direction = deserialize_value<Point>(input);
+	auto heading = deserialize_value<int>(input);
 	auto owner = deserialize_value<int>(input);
 	
 	return MissileDetails(
 		position,
 		direction,
+		heading,
 		owner
 	);
 }
+void MissileDetails::hash(StateHash& hash) const{
+	position.hash(hash);
+	direction.hash(hash);
+	hash.add(heading, owner);
+}
 
 MineDetails::MineDetails(
 	const Point& position,
@@ -212,6 +256,11 @@ MineDetails MineDetails::deserialize(istream& input){
 		owner
 	);
 }
+void MineDetails::hash(StateHash& hash) const{
+	position.hash(hash);
+	direction.hash(hash);
+	hash.add(owner);
+}
 
 
 DeathRayPath::DeathRayPath(
@@ -229,3 +278,7 @@ DeathRayPath DeathRayPath::deserialize(istream& input){
 	
 	return DeathRayPath(path, owner);
 }
+void DeathRayPath::hash(StateHash& hash) const{
+	for(const auto& point: path) point.hash(hash);
+	hash.add(owner);
+}
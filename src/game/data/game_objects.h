@@ -2,6 +2,7 @@
 #define _GAME_OBJECTS_H
 
 #include "../../utils/numbers.h"
+#include "../../utils/state_hash.h"
 
 #include <ostream>
 #include <istream>
@@ -27,6 +28,7 @@ public:
 	
 	void serialize(ostream& output) const;
 	static Maze deserialize(istream& input);
+	void hash(StateHash& hash) const;
 };
 
 class KeyState{
@@ -51,16 +53,19 @@ public:
 	TankState(
 		const Point& position,
 		const Point& direction,
+		int heading,
 		const KeyState& key_state,
 		bool active, bool alive
 	);
 
 	Point position, direction;
+	int heading;  // Index of direction among the discrete headings, -1 for a direction off them
 	KeyState key_state;
 	bool active, alive;
 	
 	void serialize(ostream& output) const;
 	static TankState deserialize(istream& input);
+	void hash(StateHash& hash) const;
 };
 
 class Upgrade {
@@ -80,6 +85,7 @@ public:
 
 	void serialize(ostream& output) const;
 	static Upgrade deserialize(istream& input);
+	void hash(StateHash& hash) const;
 };
 
 class ShotDetails{
@@ -106,6 +112,7 @@ public:
 	
 	void serialize(ostream& output) const;
 	static ShotDetails deserialize(istream& input);
+	void hash(StateHash& hash) const;
 };
 
 class ShrapnelDetails{
@@ -120,6 +127,7 @@ public:
 	
 	void serialize(ostream& output) const;
 	static ShrapnelDetails deserialize(istream& input);
+	void hash(StateHash& hash) const;
 };
 
 class MissileDetails{
@@ -127,15 +135,18 @@ public:
 	MissileDetails(
 		const Point& position,
 		const Point& direction,
+		int heading,
 		int owner
 	);
 	
 	Point position;
 	Point direction;
+	int heading;  // Same as TankState::heading
 	int owner;
 
 	void serialize(ostream& output) const;
 	static MissileDetails deserialize(istream& input);
+	void hash(StateHash& hash) const;
 };
 
 class MineDetails{
@@ -152,6 +163,7 @@ public:
 	
 	void serialize(ostream& output) const;
 	static MineDetails deserialize(istream& input);
+	void hash(StateHash& hash) const;
 };
 
 enum class MineState : unsigned char{
@@ -172,6 +184,7 @@ public:
 	
 	void serialize(ostream& output) const;
 	static DeathRayPath deserialize(istream& input);
+	void hash(StateHash& hash) const;
 };
 
 #endif
@@ -8,6 +8,7 @@ public:
 	virtual void on_shot_removed(int shot_id) {};
 	virtual void on_missile_removed(int missile_id) {};
 	virtual void on_death_ray_removed(int death_ray_id) {};
+	virtual void on_step() {};
 };
 
 #endif
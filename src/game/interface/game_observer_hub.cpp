@@ -18,3 +18,6 @@ void GameObserverHub::on_missile_removed(int missile_id){
 void GameObserverHub::on_death_ray_removed(int death_ray_id){
 	for(auto observer: observers) observer->on_death_ray_removed(death_ray_id);
 }
+void GameObserverHub::on_step(){
+	for(auto observer: observers) observer->on_step();
+}
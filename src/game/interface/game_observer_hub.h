@@ -18,6 +18,7 @@ public:
 	void on_shot_removed(int shot_id);	
 	void on_missile_removed(int missile_id);
 	void on_death_ray_removed(int death_ray_id);
+	void on_step();
 };
 
 #endif
@@ -0,0 +1,151 @@
+#include "game_snapshot.h"
+
+GameSnapshot::GameSnapshot() : round(-1), maze(nullptr) {}
+
+void GameSnapshot::capture(const GameView& view){
+	if(maze == nullptr || round != view.get_round()){
+		maze = make_unique<Maze>(view.get_maze());
+	}
+	round = view.get_round();
+
+	tanks.clear();
+	tank_upgrades.clear();
+	tank_has_upgrade.clear();
+	for(const auto& tank: view.get_states()){
+		tanks.push_back(tank.state);
+		tank_upgrades.push_back(tank.upgrade == nullptr ? TankUpgradeState({
+			.type = Upgrade::Type::GATLING,
+			.state = 0,
+			.timer = 0
+		}) : *tank.upgrade);
+		tank_has_upgrade.push_back(tank.upgrade != nullptr);
+	}
+
+	shot_ids.clear();
+	shots.clear();
+	// Paths are never dropped, so their capacity serves the shots of later captures
+	auto view_shots = view.get_shots();
+	if(shot_paths.size() < view_shots.size()) shot_paths.resize(view_shots.size());
+	for(int i = 0; i < view_shots.size(); i++){
+		shot_ids.push_back(view_shots[i].id);
+		shots.push_back(view_shots[i].state);
+		shot_paths[i].assign(view_shots[i].path.begin(), view_shots[i].path.end());
+	}
+
+	missile_ids.clear();
+	missiles.clear();
+	missile_targets.clear();
+	for(const auto& missile: view.get_missiles()){
+		missile_ids.push_back(missile.id);
+		missiles.push_back(missile.state);
+		missile_targets.push_back(missile.target);
+	}
+
+	shrapnels.clear();
+	for(auto shrapnel: view.get_shrapnels()){
+		shrapnels.push_back(*shrapnel);
+	}
+
+	mines.clear();
+	mine_states.clear();
+	for(const auto& mine: view.get_mines()){
+		mines.push_back(mine.details);
+		mine_states.push_back(mine.state);
+	}
+
+	death_rays.clear();
+	death_ray_timers.clear();
+	for(const auto& death_ray: view.get_death_rays()){
+		death_rays.push_back(death_ray.path);
+		death_ray_timers.push_back(death_ray.timer);
+	}
+
+	// The set is ordered by address, so the upgrades already held can be overwritten in place
+	const auto& view_upgrades = view.get_upgrades();
+	while(upgrades.size() > view_upgrades.size()) upgrades.erase(upgrades.begin());
+	auto held = upgrades.begin();
+	for(const auto& upgrade: view_upgrades){
+		if(held == upgrades.end()) upgrades.insert(make_unique<Upgrade>(*upgrade));
+		else **(held++) = *upgrade;
+	}
+
+	update_views();
+}
+
+void GameSnapshot::update_views(){
+	states_buffer.clear();
+	for(int i = 0; i < tanks.size(); i++){
+		states_buffer.push_back({
+			.state = tanks[i],
+			.upgrade = tank_has_upgrade[i] ? &tank_upgrades[i] : nullptr
+		});
+	}
+
+	shots_buffer.clear();
+	for(int i = 0; i < shots.size(); i++){
+		shots_buffer.push_back({
+			.id = shot_ids[i],
+			.state = shots[i],
+			.path = shot_paths[i]
+		});
+	}
+
+	missiles_buffer.clear();
+	for(int i = 0; i < missiles.size(); i++){
+		missiles_buffer.push_back({
+			.id = missile_ids[i],
+			.state = missiles[i],
+			.target = missile_targets[i]
+		});
+	}
+
+	shrapnels_buffer.clear();
+	for(const auto& shrapnel: shrapnels){
+		shrapnels_buffer.push_back(&shrapnel);
+	}
+
+	mines_buffer.clear();
+	for(int i = 0; i < mines.size(); i++){
+		mines_buffer.push_back({
+			.details = mines[i],
+			.state = mine_states[i]
+		});
+	}
+
+	death_rays_buffer.clear();
+	for(int i = 0; i < death_rays.size(); i++){
+		death_rays_buffer.push_back({
+			.path = death_rays[i],
+			.timer = death_ray_timers[i]
+		});
+	}
+}
+
+int GameSnapshot::get_round() const{
+	return round;
+}
+const Maze& GameSnapshot::get_maze() const{
+	return *maze;
+}
+
+Span<TankCompleteState> GameSnapshot::get_states() const{
+	return states_buffer;
+}
+Span<ShotPath> GameSnapshot::get_shots() const{
+	return shots_buffer;
+}
+Span<MissileState> GameSnapshot::get_missiles() const{
+	return missiles_buffer;
+}
+Span<const ShrapnelState*> GameSnapshot::get_shrapnels() const{
+	return shrapnels_buffer;
+}
+Span<MineCompleteState> GameSnapshot::get_mines() const{
+	return mines_buffer;
+}
+Span<DeathRayState> GameSnapshot::get_death_rays() const{
+	return death_rays_buffer;
+}
+const set<unique_ptr<Upgrade>>& GameSnapshot::get_upgrades() const{
+	return upgrades;
+}
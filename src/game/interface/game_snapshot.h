@@ -0,0 +1,67 @@
+#ifndef _GAME_SNAPSHOT_H
+#define _GAME_SNAPSHOT_H
+
+#include "game_view.h"
+
+#include "../data/game_objects.h"
+
+#include <vector>
+#include <set>
+#include <memory>
+
+using namespace std;
+
+// Owning copy of a GameView, which stays valid while the game keeps advancing
+class GameSnapshot : public GameView{
+	int round;
+	unique_ptr<Maze> maze;
+
+	vector<TankState> tanks;
+	vector<TankUpgradeState> tank_upgrades;
+	vector<bool> tank_has_upgrade;
+
+	vector<int> shot_ids;
+	vector<ShotDetails> shots;
+	vector<vector<TimePoint>> shot_paths;
+
+	vector<int> missile_ids;
+	vector<MissileDetails> missiles;
+	vector<int> missile_targets;
+
+	vector<ShrapnelState> shrapnels;
+
+	vector<MineDetails> mines;
+	vector<MineState> mine_states;
+
+	vector<DeathRayPath> death_rays;
+	vector<int> death_ray_timers;
+
+	set<unique_ptr<Upgrade>> upgrades;
+
+	// Views over the copies above, built once per capture
+	vector<TankCompleteState> states_buffer;
+	vector<ShotPath> shots_buffer;
+	vector<MissileState> missiles_buffer;
+	vector<const ShrapnelState*> shrapnels_buffer;
+	vector<MineCompleteState> mines_buffer;
+	vector<DeathRayState> death_rays_buffer;
+
+	void update_views();
+public:
+	GameSnapshot();
+
+	void capture(const GameView& view);
+
+	int get_round() const;
+	const Maze& get_maze() const;
+
+	Span<TankCompleteState> get_states() const;
+	Span<ShotPath> get_shots() const;
+	Span<MissileState> get_missiles() const;
+	Span<const ShrapnelState*> get_shrapnels() const;
+	Span<MineCompleteState> get_mines() const;
+	Span<DeathRayState> get_death_rays() const;
+	const set<unique_ptr<Upgrade>>& get_upgrades() const;
+};
+
+#endif
@@ -3,6 +3,8 @@
 
 #include "../data/game_objects.h"
 
+#include "../../utils/span.h"
+
 #include <vector>
 #include <set>
 #include <memory>
@@ -16,7 +18,7 @@ struct ShotPath{
 };
 
 struct TankUpgradeState{
-	const Upgrade::Type type;
+	Upgrade::Type type;
 	int state;
 	int timer;
 };
@@ -33,6 +35,7 @@ struct ShrapnelState{
 };
 
 struct MissileState{
+	int id;
 	const MissileDetails& state;
 	int target;
 };
@@ -47,17 +50,18 @@ struct DeathRayState{
 	int timer;
 };
 
+// Spans stay valid until the game advances or loads, getters don't modify anything so concurrent readers are safe
 class GameView{
 public:
 	virtual int get_round() const = 0;
 	virtual const Maze& get_maze() const = 0;
 
-	virtual vector<TankCompleteState> get_states() const = 0;
-	virtual vector<ShotPath> get_shots() const = 0;
-	virtual vector<MissileState> get_missiles() const = 0;
-	virtual vector<const ShrapnelState*> get_shrapnels() const = 0;
-	virtual vector<MineCompleteState> get_mines() const = 0;
-	virtual vector<DeathRayState> get_death_rays() const = 0;
+	virtual Span<TankCompleteState> get_states() const = 0;
+	virtual Span<ShotPath> get_shots() const = 0;
+	virtual Span<MissileState> get_missiles() const = 0;
+	virtual Span<const ShrapnelState*> get_shrapnels() const = 0;
+	virtual Span<MineCompleteState> get_mines() const = 0;
+	virtual Span<DeathRayState> get_death_rays() const = 0;
 	virtual const set<unique_ptr<Upgrade>>& get_upgrades() const = 0;
 };
 
@@ -1,10 +1,15 @@
 #include "game.h"
 
 #include "../../utils/utils.h"
+#include "../../utils/serialization.h"
 
 #include "geometry.h"
 #include "logic.h"
 
+const int MAX_SHOTS = 5;
+const int EXPLOSION_SHRAPNEL_COUNT = 100;
+const int MINE_COUNT = 3;
+
 Game::Game(
 	MazeGeneration maze_generation,
 	const set<Upgrade::Type> allowed_upgrades,
@@ -13,42 +18,131 @@ Game::Game(
 	maze_generation(maze_generation),
 	allowed_upgrades(allowed_upgrades.begin(), allowed_upgrades.end()),
 	tanks(),
-	round_num(-1) {
+	round_num(-1),
+	arena_peak_bytes(0),
+	state_hash(0) {
 		
 	for(int i = 0; i < tank_num; i++){
 		tanks.push_back(Tank(*this, i));
 	}
+	for(const auto& tank: tanks){
+		tank_states.push_back(&tank.get_state());
+	}
+
+	// Sized for what a match usually holds, so the views rarely grow during a tick
+	states_buffer.reserve(tank_num);
+	shots_buffer.reserve(tank_num * MAX_SHOTS);
+	missiles_buffer.reserve(tank_num);
+	shrapnels_buffer.reserve(EXPLOSION_SHRAPNEL_COUNT);
+	mines_buffer.reserve(tank_num * MINE_COUNT);
+	death_rays_buffer.reserve(tank_num);
 		
 	new_round();
 }
 
+void Game::update_views(){
+	states_buffer.clear();
+	for(const auto& tank: tanks){
+		states_buffer.push_back({
+			.state = tank.get_state(),
+			.upgrade = tank.get_upgrade(),
+		});
+	}
+
+	shots_buffer.clear();
+	for(const auto& entry: round->get_shots()){
+		shots_buffer.push_back(ShotPath({
+			.id=entry.first,
+			.state=entry.second->get_state(),
+			.path=entry.second->get_path()
+		}))	;
+	}
+
+	missiles_buffer.clear();
+	for(const auto& entry: round->get_missiles()){
+		missiles_buffer.push_back({
+			.id=entry.first,
+			.state=entry.second->get_state(),
+			.target=entry.second->get_target()
+		});
+	}
+
+	shrapnels_buffer.clear();
+	for(const auto& shrapnel: round->get_shrapnels()){
+		shrapnels_buffer.push_back(&shrapnel->get_state());
+	}
+
+	mines_buffer.clear();
+	for(const auto& entry: round->get_mines()){
+		mines_buffer.push_back({
+			.details=entry.second->get_details(),
+			.state=entry.second->get_state()
+		});
+	}
+
+	death_rays_buffer.clear();
+	for(const auto& [id, death_ray]: round->get_death_rays()){
+		death_rays_buffer.push_back({
+			.path = death_ray->get_path(),
+			.timer = death_ray->get_timer()
+		});
+	}
+}
+
 void Game::new_round(){
 	round_num += 1;
 
+	if(round != nullptr) arena_peak_bytes = get_arena_peak_bytes();
+
 	round = make_unique<Round>(*this, maze_generation, allowed_upgrades);
 
 	for(auto& tank: tanks){
 		tank.reset(round->get_maze().get_w(), round->get_maze().get_h());
 	}
+	update_views();
 };
 
 bool Game::can_step() const{
+	bool any_active = false;
 	for(const auto& tank: tanks){
 		if(!tank.can_advance()) return false;
+		if(tank.get_state().active) any_active = true;
 	}
-	return true;
+	return any_active;
 }
-void Game::step(){
-	for(auto& tank: tanks){
-		tank.advance(*round);
+void Game::step(const KeyState* keys){
+	TICK_PROFILE_BEGIN(tick_profile, TANKS, tanks.size());
+	for(int i = 0; i < tanks.size(); i++){
+		if(keys == nullptr) tanks[i].advance(*round);
+		else tanks[i].advance(*round, keys[i]);
 	}
+	TICK_PROFILE_END(tick_profile, TANKS);
 	round->step();
+
+	TICK_PROFILE_BEGIN(tick_profile, STATE_HASH, tanks.size());
+	StateHash hash(state_hash);
+	hash.add(round_num);
+	hash_random_state(hash);
+	round->hash(hash);
+	for(const auto& tank: tanks) tank.hash(hash);
+	state_hash = hash.get();
+	TICK_PROFILE_END(tick_profile, STATE_HASH);
+
+	update_views();
+	on_step();
 }
 
 PlayerInterface& Game::get_player_interface(int player){
 	return tanks[player];
 }
 
+MazeGeneration Game::get_maze_generation() const{
+	return maze_generation;
+}
+const vector<Upgrade::Type>& Game::get_allowed_upgrades() const{
+	return allowed_upgrades;
+}
+
 
 int Game::get_round() const{
 	return round_num;
@@ -57,96 +151,138 @@ int Game::get_round() const{
 const Maze& Game::get_maze() const{
 	return round->get_maze();
 }
-vector<TankCompleteState> Game::get_states() const{
-	vector<TankCompleteState> states;
-	for(const auto& tank: tanks){
-		const auto& upgrade = tank.get_upgrade();
-		states.push_back({
-			.state = tank.get_state(),
-			.upgrade = upgrade == nullptr ? nullptr : &upgrade->get_state(),
-		});
-	}
-	return states;
+const MazeMap& Game::get_maze_map() const{
+	return round->get_maze_map();
 }
-vector<ShotPath> Game::get_shots() const{
-	vector<ShotPath> shots;
-	for(const auto& entry: round->get_shots()){
-		shots.push_back(ShotPath({
-			.id=entry.first,
-			.state=entry.second->get_state(),
-			.path=entry.second->get_path()
-		}))	;
-	}
-
-	return shots;
+Span<TankCompleteState> Game::get_states() const{
+	return states_buffer;
 }
-vector<MissileState> Game::get_missiles() const{
-	vector<MissileState> missiles;
-	for(const auto& entry: round->get_missiles()){
-		missiles.push_back({
-			.state=entry.second->get_state(),
-			.target=entry.second->get_target()
-		});
-	}
-	return missiles;
+Span<ShotPath> Game::get_shots() const{
+	return shots_buffer;
 }
-vector<const ShrapnelState*> Game::get_shrapnels() const{
-	vector<const ShrapnelState*> shrapnels;
-	for(const auto& shrapnel: round->get_shrapnels()){
-		shrapnels.push_back(&shrapnel->get_state());
-	}
-	return shrapnels;
+Span<MissileState> Game::get_missiles() const{
+	return missiles_buffer;
 }
-vector<MineCompleteState> Game::get_mines() const{
-	vector<MineCompleteState> mines;
-	for(const auto& entry: round->get_mines()){
-		mines.push_back({
-			.details=entry.second->get_details(),
-			.state=entry.second->get_state()
-		});
-	}
-	return mines;
+Span<const ShrapnelState*> Game::get_shrapnels() const{
+	return shrapnels_buffer;
 }
-vector<DeathRayState> Game::get_death_rays() const{
-	vector<DeathRayState> death_rays;
-	for(const auto& [id, death_ray]: round->get_death_rays()){
-		death_rays.push_back({
-			.path = death_ray->get_path(),
-			.timer = death_ray->get_timer()
-		});
-	}
-	return death_rays;
+Span<MineCompleteState> Game::get_mines() const{
+	return mines_buffer;
+}
+Span<DeathRayState> Game::get_death_rays() const{
+	return death_rays_buffer;
 }
 const set<unique_ptr<Upgrade>>& Game::get_upgrades() const{
 	return round->get_upgrades();
 }
 
+const vector<const TankState*>& Game::get_tank_states() const{
+	return tank_states;
+}
+
+const ArenaStats& Game::get_arena_stats() const{
+	return round->get_arena_stats();
+}
+size_t Game::get_arena_peak_bytes() const{
+	size_t current_peak = round->get_arena_stats().peak_live_bytes;
+	return current_peak > arena_peak_bytes ? current_peak : arena_peak_bytes;
+}
+
+uint64_t Game::get_state_hash() const{
+	return state_hash;
+}
+
+#ifdef TICK_PROFILING
+TickProfile& Game::get_tick_profile(){
+	return tick_profile;
+}
+const TickProfile& Game::get_tick_profile() const{
+	return tick_profile;
+}
+#endif
+
 void Game::advance(){
-	while(can_step()) step();
+	TRACE_SCOPE("Game::advance");
+	while(can_step()) step(nullptr);
 }
 
 void Game::allow_step(){}
 
+void Game::advance_with(Span<KeyState> keys){
+	step(keys.begin());
+}
+
 void Game::kill_tank(int index){
 	tanks[index].kill();
 }
 void Game::upgrade_tank(int index, Upgrade::Type type){
 	tanks[index].set_upgrade(type);
+	states_buffer[index].upgrade = tanks[index].get_upgrade();
+}
+const TankUpgradeState* Game::get_tank_upgrade(int index) const{
+	return tanks[index].get_upgrade();
+}
+void Game::notify_shot_removed(int owner, int shot_id){
+	tanks[owner].on_shot_removed(shot_id, *round);
+	on_shot_removed(shot_id);
+}
+
+void Game::serialize(ostream& output) const{
+	serialize_value(output, round_num);
+	serialize_value(output, (unsigned long long)state_hash);
+	serialize_random_state(output);
+	round->serialize(output);
+	for(const auto& tank: tanks) tank.serialize(output);
+}
+void Game::load(istream& input){
+	round_num = deserialize_value<int>(input);
+	state_hash = deserialize_value<unsigned long long>(input);
+	deserialize_random_state(input);
+	round = Round::deserialize(input, *this, allowed_upgrades);
+	for(auto& tank: tanks) tank.load(input, *round);
+	update_views();
 }
 
 const int MAX_UPGRADE_TIME = 120;
 const int MIN_UPGRADE_TIME = 60;
 
+static uint64_t get_flight_hash(const ShrapnelState& shrapnel){
+	StateHash hash;
+	shrapnel.details.hash(hash);
+	shrapnel.collision.hash(hash);
+	return hash.get();
+}
+
 Round::Round(Game& game, MazeGeneration maze_generation, const vector<Upgrade::Type>& allowed_upgrades) :
 	game(game),
 	allowed_upgrades(allowed_upgrades),
-	next_id(0),
+	shrapnels_hash(0),
+	shrapnel_timers(0),
+	upgrades_hash(0),
 	upgrade_timer(rand_range(MIN_UPGRADE_TIME, MAX_UPGRADE_TIME)),
 	maze(generate_maze(maze_generation, rand_range(5, 12), rand_range(5, 12))),
-	maze_map(maze) {
+	maze_map(maze),
+	maze_hash(get_state_hash(maze)) {
 
 }
 
+Round::Round(Game& game, const vector<Upgrade::Type>& allowed_upgrades, Maze&& maze) :
+	game(game),
+	allowed_upgrades(allowed_upgrades),
+	shrapnels_hash(0),
+	shrapnel_timers(0),
+	upgrades_hash(0),
+	upgrade_timer(0),
+	maze(move(maze)),
+	maze_map(this->maze),
+	maze_hash(get_state_hash(this->maze)) {
+
+}
+
+const ArenaStats& Round::get_arena_stats() const{
+	return arena.get_stats();
+}
+
 const Maze& Round::get_maze() const{
 	return maze;
 }
@@ -154,75 +290,70 @@ const MazeMap& Round::get_maze_map() const{
 	return maze_map;
 }
 
-int Round::add_shot(unique_ptr<Shot>&& shot){
-	int shot_id = next_id++;
-	shots.insert({shot_id, move(shot)});
-	return shot_id;
+int Round::add_shot(ArenaPtr<Shot>&& shot){
+	return shots.insert(move(shot));
 }
 void Round::remove_shot(int shot_id){
-	game.on_shot_removed(shot_id);
+	auto shot = get_shot(shot_id);
+	if(shot == nullptr) return;
+
+	game.notify_shot_removed(shot->get_state().owner, shot_id);
 	shots.erase(shot_id);
 }
 Shot* Round::get_shot(int shot_id) const{
-	auto it = shots.find(shot_id);
-	if(it == shots.end()) return nullptr;
-	return it->second.get();
+	auto shot = shots.get(shot_id);
+	if(shot == nullptr) return nullptr;
+	return shot->get();
 }
-const map<int, unique_ptr<Shot>>& Round::get_shots() const{
+const SlotMap<ArenaPtr<Shot>>& Round::get_shots() const{
 	return shots;
 }
 
-int Round::add_missile(unique_ptr<Missile>&& missile){
-	int missile_id = next_id++;
-	missiles.insert({missile_id, move(missile)});
-	return missile_id;
+int Round::add_missile(ArenaPtr<Missile>&& missile){
+	return missiles.insert(move(missile));
 }
 void Round::remove_missile(int missile_id){
 	game.on_missile_removed(missile_id);
 	missiles.erase(missile_id);
 }
 Missile* Round::get_missile(int missile_id) const{
-	auto it = missiles.find(missile_id);
-	if(it == missiles.end()) return nullptr;
-	return it->second.get();
+	auto missile = missiles.get(missile_id);
+	if(missile == nullptr) return nullptr;
+	return missile->get();
 }
-const map<int, unique_ptr<Missile>>& Round::get_missiles() const{
+const SlotMap<ArenaPtr<Missile>>& Round::get_missiles() const{
 	return missiles;
 }
 
-int Round::add_mine(unique_ptr<Mine>&& mine){
-	int mine_id = next_id++;
-	mines.insert({mine_id, move(mine)});
-	return mine_id;
+int Round::add_mine(ArenaPtr<Mine>&& mine){
+	return mines.insert(move(mine));
 }
 void Round::remove_mine(int mine_id){
-	explode(mines[mine_id]->get_details().position);
+	explode(get_mine(mine_id)->get_details().position);
 	mines.erase(mine_id);
 }
 Mine* Round::get_mine(int mine_id) const{
-	auto it = mines.find(mine_id);
-	if(it == mines.end()) return nullptr;
-	return it->second.get();
+	auto mine = mines.get(mine_id);
+	if(mine == nullptr) return nullptr;
+	return mine->get();
 }
-const map<int, unique_ptr<Mine>>& Round::get_mines() const{
+const SlotMap<ArenaPtr<Mine>>& Round::get_mines() const{
 	return mines;
 }
 
-int Round::add_death_ray(unique_ptr<DeathRay>&& death_ray){
-	int death_ray_id = next_id++;
-	death_rays.insert({death_ray_id, move(death_ray)});
-	return death_ray_id;
+int Round::add_death_ray(ArenaPtr<DeathRay>&& death_ray){
+	return death_rays.insert(move(death_ray));
 }
 void Round::remove_death_ray(int death_ray_id){
 	game.on_death_ray_removed(death_ray_id);
 	death_rays.erase(death_ray_id);
 }
 DeathRay* Round::get_death_ray(int death_ray_id) const{
-	auto it = death_rays.find(death_ray_id);
-	if(it == death_rays.end()) return nullptr;
-	return it->second.get();
+	auto death_ray = death_rays.get(death_ray_id);
+	if(death_ray == nullptr) return nullptr;
+	return death_ray->get();
 }
-const map<int, unique_ptr<DeathRay>>& Round::get_death_rays() const{
+const SlotMap<ArenaPtr<DeathRay>>& Round::get_death_rays() const{
 	return death_rays;
 }
 
@@ -230,7 +361,6 @@ const map<int, unique_ptr<DeathRay>>& Round::get_death_rays() const{
 
 const Number EXPLOSION_SIZE = 5;
 const Number MIN_EXPLOSION_RANGE = 4;
-const int EXPLOSION_SHRAPNEL_COUNT = 100;
 
 void Round::explode(const Point& source){
 	vector<ShrapnelDetails> new_shrapnels;
@@ -239,11 +369,13 @@ void Round::explode(const Point& source){
 			source, random_direction() * Number::random(MIN_EXPLOSION_RANGE, EXPLOSION_SIZE)
 		));
 	}
-	for(const auto& shrapnel: new_shrapnels) shrapnels.insert(make_unique<Shrapnel>(
-		shrapnel, maze
-	));
+	for(const auto& details: new_shrapnels){
+		auto shrapnel = arena.create<Shrapnel>(details, maze);
+		shrapnels_hash += get_flight_hash(shrapnel->get_state());
+		shrapnels.insert(move(shrapnel));
+	}
 }
-const set<unique_ptr<Shrapnel>>& Round::get_shrapnels() const{
+const set<ArenaPtr<Shrapnel>>& Round::get_shrapnels() const{
 	return shrapnels;
 }
 
@@ -260,49 +392,156 @@ void Round::create_upgrade(){
 	for(const auto& upgrade: upgrades){
 		if(upgrade->x == x && upgrade->y == y) return;
 	}
-	for(const auto& tank: game.get_states()){
-		int tank_x = tank.state.position.x;
-		int tank_y = tank.state.position.y;
+	for(auto tank: game.get_tank_states()){
+		int tank_x = tank->position.x;
+		int tank_y = tank->position.y;
 		if(tank_x == x && tank_y == y) return;
 	}
 	
-	upgrades.insert(make_unique<Upgrade>(
+	auto upgrade = make_unique<Upgrade>(
 		x, y,
 		allowed_upgrades[rand_range(0, allowed_upgrades.size())]
-	));
+	);
+	upgrades_hash += get_state_hash(*upgrade);
+	upgrades.insert(move(upgrade));
+}
+
+void Round::serialize(ostream& output) const{
+	serialize_value(output, maze);
+	serialize_value(output, upgrade_timer);
+
+	shots.serialize(output, [](ostream& output, const ArenaPtr<Shot>& shot){
+		shot->serialize(output);
+	});
+	serialize_value(output, removed_shots);
+
+	serialize_value(output, (unsigned int)shrapnels.size());
+	for(const auto& shrapnel: shrapnels) shrapnel->serialize(output);
+
+	missiles.serialize(output, [](ostream& output, const ArenaPtr<Missile>& missile){
+		missile->serialize(output);
+	});
+	serialize_value(output, removed_missiles);
+
+	mines.serialize(output, [](ostream& output, const ArenaPtr<Mine>& mine){
+		mine->serialize(output);
+	});
+
+	death_rays.serialize(output, [](ostream& output, const ArenaPtr<DeathRay>& death_ray){
+		death_ray->serialize(output);
+	});
+
+	serialize_value(output, (unsigned int)upgrades.size());
+	for(const auto& upgrade: upgrades) serialize_value(output, *upgrade);
+}
+unique_ptr<Round> Round::deserialize(istream& input, Game& game, const vector<Upgrade::Type>& allowed_upgrades){
+	auto round = make_unique<Round>(game, allowed_upgrades, deserialize_value<Maze>(input));
+	round->upgrade_timer = deserialize_value<int>(input);
+
+	round->shots.load(input, [&](istream& input){
+		return round->create<Shot>(Shot::deserialize(input));
+	});
+	round->removed_shots = deserialize_value<vector<int>>(input);
+
+	auto shrapnel_num = deserialize_value<unsigned int>(input);
+	for(unsigned int i = 0; i < shrapnel_num; i++){
+		auto shrapnel = round->create<Shrapnel>(Shrapnel::deserialize(input));
+		round->shrapnels_hash += get_flight_hash(shrapnel->get_state());
+		round->shrapnels.insert(move(shrapnel));
+	}
+
+	round->missiles.load(input, [&](istream& input){
+		return round->create<Missile>(Missile::deserialize(input, *round));
+	});
+	round->removed_missiles = deserialize_value<vector<int>>(input);
+
+	round->mines.load(input, [&](istream& input){
+		return round->create<Mine>(Mine::deserialize(input));
+	});
+
+	round->death_rays.load(input, [&](istream& input){
+		return round->create<DeathRay>(DeathRay::deserialize(input));
+	});
+
+	auto upgrade_num = deserialize_value<unsigned int>(input);
+	for(unsigned int i = 0; i < upgrade_num; i++){
+		auto upgrade = make_unique<Upgrade>(deserialize_value<Upgrade>(input));
+		round->upgrades_hash += get_state_hash(*upgrade);
+		round->upgrades.insert(move(upgrade));
+	}
+
+	return round;
+}
+// The dense order of a slot map depends on the order of removals, so the hashes of its entries are summed
+template<typename T>
+static uint64_t get_entries_hash(const SlotMap<ArenaPtr<T>>& entries){
+	uint64_t sum = 0;
+	for(const auto& [id, entry]: entries){
+		StateHash hash;
+		hash.add(id);
+		entry->hash(hash);
+		sum += hash.get();
+	}
+	return sum;
+}
+
+void Round::hash(StateHash& hash) const{
+	hash.add(maze_hash);
+	hash.add(upgrade_timer, (int)upgrades.size());
+	hash.add((int)shots.size(), (int)missiles.size());
+	hash.add((int)mines.size(), (int)death_rays.size());
+
+	hash.add(get_entries_hash(shots));
+	for(int shot_id: removed_shots) hash.add(shot_id);
+	hash.add(get_entries_hash(missiles));
+	for(int missile_id: removed_missiles) hash.add(missile_id);
+	hash.add(get_entries_hash(mines));
+	hash.add(get_entries_hash(death_rays));
+
+	// Shrapnels and upgrades are ordered by address, which differs between peers, so their hashes are summed
+	hash.add(shrapnels_hash);
+	hash.add((int)shrapnels.size(), shrapnel_timers);
+	hash.add(upgrades_hash);
 }
 
 void Round::step(){
+	TICK_PROFILE_BEGIN(game.get_tick_profile(), SHOTS, shots.size());
 	for(int shot_id: removed_shots){
 		remove_shot(shot_id);
 	}
 	removed_shots.clear();
 	for(const auto& shot_entry: shots){
 		if(shot_entry.second->advance(game)){
-			removed_shots.insert(shot_entry.first);
+			removed_shots.push_back(shot_entry.first);
 		}
 	}
+	TICK_PROFILE_END(game.get_tick_profile(), SHOTS);
 
+	TICK_PROFILE_BEGIN(game.get_tick_profile(), MISSILES, missiles.size());
 	for(int missile_id: removed_missiles){
 		remove_missile(missile_id);
 	}
 	removed_missiles.clear();
 	for(const auto& missile_entry: missiles){
 		if(missile_entry.second->advance(game)){
-			removed_missiles.insert(missile_entry.first);
+			removed_missiles.push_back(missile_entry.first);
 		}
 	}
+	TICK_PROFILE_END(game.get_tick_profile(), MISSILES);
 	
+	TICK_PROFILE_BEGIN(game.get_tick_profile(), MINES, mines.size());
 	vector<int> removed_mines;
 	for(const auto& mine_entry: mines){
-		if(mine_entry.second->step(game.get_states())){
+		if(mine_entry.second->step(game.get_tank_states())){
 			removed_mines.push_back(mine_entry.first);
 		}
 	}
 	for(int mine_id: removed_mines){
 		remove_mine(mine_id);
 	}
+	TICK_PROFILE_END(game.get_tick_profile(), MINES);
 
+	TICK_PROFILE_BEGIN(game.get_tick_profile(), DEATH_RAYS, death_rays.size());
 	vector<int> removed_death_rays;
 	for(const auto& [id, death_ray]: death_rays){
 		if(death_ray->advance(game)){
@@ -312,84 +551,59 @@ void Round::step(){
 	for(int death_ray_id: removed_death_rays){
 		remove_death_ray(death_ray_id);
 	}
+	TICK_PROFILE_END(game.get_tick_profile(), DEATH_RAYS);
 	
-	vector<const unique_ptr<Shrapnel>*> removed_shrapnel;
+	TICK_PROFILE_BEGIN(game.get_tick_profile(), SHRAPNEL, shrapnels.size());
+	vector<const ArenaPtr<Shrapnel>*> removed_shrapnel;
+	shrapnel_timers = 0;
 	for(const auto& shrapnel: shrapnels){
 		if(shrapnel->advance(game)) removed_shrapnel.push_back(&shrapnel);
+		else shrapnel_timers += shrapnel->get_state().timer;
 	}
 	for(auto shrapnel: removed_shrapnel){
+		shrapnels_hash -= get_flight_hash((*shrapnel)->get_state());
 		shrapnels.erase(*shrapnel);
 	}
+	TICK_PROFILE_END(game.get_tick_profile(), SHRAPNEL);
 	
+	TICK_PROFILE_BEGIN(game.get_tick_profile(), UPGRADES, upgrades.size());
 	upgrade_timer--;
 	if(upgrade_timer == 0){
 		create_upgrade();
 		upgrade_timer = rand_range(MIN_UPGRADE_TIME, MAX_UPGRADE_TIME);
 	}
 
-	const auto tanks = game.get_states();
+	const auto& tanks = game.get_tank_states();
 	for(int i = 0; i < tanks.size(); i++){
-		if(tanks[i].upgrade != nullptr) continue;
+		if(game.get_tank_upgrade(i) != nullptr) continue;
 		for(const auto& upgrade: upgrades){
-			if(check_upgrade_collision(tanks[i].state, *upgrade)){
+			if(check_upgrade_collision(*tanks[i], *upgrade)){
 				game.upgrade_tank(i, upgrade->type);
+				upgrades_hash -= get_state_hash(*upgrade);
 				upgrades.erase(upgrade);
 				break;
 			}
 		}
 	}
+	TICK_PROFILE_END(game.get_tick_profile(), UPGRADES);
 }
 
-WeaponManager::WeaponManager() {}
-WeaponManager::~WeaponManager() {}
-
 const Number CANNON_LENGTH = Number(17)/100;
 
 const Number SHOT_RADIUS = Number(3)/100;
 const Number SHOT_SPEED = Number(1)/25;
 const int SHOT_TTL = 1200;
-const int MAX_SHOTS = 5;
-
-ShotManager::ShotManager(int owner, Game& game) : owner(owner), game(game) {
-	game.add_observer(this);
-}
-ShotManager::~ShotManager() {
-	game.remove_observer(this);
-}
-
-void ShotManager::on_shot_removed(int shot_id){
-	if(shots.count(shot_id)) shots.erase(shot_id);
-}
 
-bool ShotManager::step(
-	const TankState& owner_state,
-	const KeyState& previous_keys,
-	Round& round
-){
-	if(owner_state.key_state.shoot && !previous_keys.shoot && shots.size() < MAX_SHOTS){
-		shots.insert(round.add_shot(make_unique<Shot>(ShotDetails(
-			owner_state.position + owner_state.direction * CANNON_LENGTH,
-			owner_state.direction * SHOT_SPEED,
+void Tank::step_shots(const KeyState& previous_keys, Round& round){
+	if(state.key_state.shoot && !previous_keys.shoot && shots.size() < MAX_SHOTS){
+		shots.push_back(round.add_shot(round.create<Shot>(ShotDetails(
+			state.position + state.direction * CANNON_LENGTH,
+			state.direction * SHOT_SPEED,
 			SHOT_RADIUS, SHOT_TTL, ShotDetails::Type::ROUND,
-			owner
+			index
 		))));
 	}
-	return false;
-}
-
-void ShotManager::reset(){
-	shots.clear();
-}
-
-AppliedUpgrade::AppliedUpgrade(TankUpgradeState state) : state(state) {}
-const TankUpgradeState& AppliedUpgrade::get_state() const{
-	return state;
 }
-bool AppliedUpgrade::allow_moving() const{
-	return true;
-}
-
-void AppliedUpgrade::reset() {}
 
 
 const Number GATLING_RADIUS = Number(3)/200;
@@ -399,34 +613,20 @@ const int GATLING_TTL = 600;
 const int GATLING_INTERVAL = 10;
 const int GATLING_START_TIME = 30;
 
-GatlingShotManager::GatlingShotManager(int owner) : 
-	AppliedUpgrade({
-		.type = Upgrade::Type::GATLING,
-		.state = 0,
-		.timer = -GATLING_START_TIME
-	}),
-	owner(owner) {
-
-}
-
-bool GatlingShotManager::step(
-	const TankState& owner_state,
-	const KeyState& previous_keys,
-	Round& round
-){
-	if(owner_state.key_state.shoot && !previous_keys.shoot) state.state = 1;
-	if(state.state){
-		if(!owner_state.key_state.shoot) return true;
-		state.timer++;
-		if(state.timer >= 0 && state.timer % GATLING_INTERVAL == 0){
+bool Tank::step_gatling(const KeyState& previous_keys, Round& round){
+	if(state.key_state.shoot && !previous_keys.shoot) upgrade.state = 1;
+	if(upgrade.state){
+		if(!state.key_state.shoot) return true;
+		upgrade.timer++;
+		if(upgrade.timer >= 0 && upgrade.timer % GATLING_INTERVAL == 0){
 			Point variance = { .x = 1, .y = rand_range(-1000, 1000) * GATLING_VARIANCE / 1000 };
 			normalize(variance);
 			
-			round.add_shot(make_unique<Shot>(ShotDetails(
-				owner_state.position + owner_state.direction * CANNON_LENGTH,
-				rotate(owner_state.direction, variance) * GATLING_SPEED,
+			round.add_shot(round.create<Shot>(ShotDetails(
+				state.position + state.direction * CANNON_LENGTH,
+				rotate(state.direction, variance) * GATLING_SPEED,
 				GATLING_RADIUS, GATLING_TTL, ShotDetails::Type::ROUND,
-				owner
+				index
 			)));
 		}
 		
@@ -435,120 +635,63 @@ bool GatlingShotManager::step(
 }
 
 
-LaserManager::LaserManager(int owner) : 
-	AppliedUpgrade({
-		.type = Upgrade::Type::LASER,
-		.state = 0,
-		.timer = 0,
-	}),
-	owner(owner) {
-	
-}
-
-bool LaserManager::step(
-	const TankState& owner_state,
-	const KeyState& previous_keys,
-	Round& round
-) {
-	if(owner_state.key_state.shoot && !previous_keys.shoot) {
-		round.add_shot(make_unique<Shot>(ShotDetails(
-			owner_state.position + owner_state.direction * CANNON_LENGTH,
-			owner_state.direction * LASER_SPEED,
+bool Tank::step_laser(const KeyState& previous_keys, Round& round){
+	if(state.key_state.shoot && !previous_keys.shoot) {
+		round.add_shot(round.create<Shot>(ShotDetails(
+			state.position + state.direction * CANNON_LENGTH,
+			state.direction * LASER_SPEED,
 			LASER_RADIUS, LASER_TTL, ShotDetails::Type::LASER,
-			owner
+			index
 		)));
 		return true;
 	}
 	return false;
 }
 
-BombManager::BombManager(int owner, Game& game) :
-	AppliedUpgrade({
-		.type = Upgrade::Type::BOMB,
-		.state = 0,
-		.timer = 0,
-	}),
-	game(game),
-	round(nullptr),
-	owner(owner) {
-	
-	game.add_observer(this);
-}
-
-BombManager::~BombManager(){
-	game.remove_observer(this);
-}
-
-void BombManager::on_shot_removed(int shot_id){
-	if(round != nullptr && state.state && shot_id == shot) {
-		round->explode(round->get_shot(shot)->get_state().position);
-	}
-}
 
 const Number BOMB_SPEED = Number(4) / 100;
 const Number BOMB_RADIUS = Number(5) / 100;
 
-bool BombManager::step(
-	const TankState& owner_state,
-	const KeyState& previous_keys,
-	Round& round
-){
-	this->round = &round;
-	if(state.state && round.get_shot(shot) == nullptr) return true;
+bool Tank::step_bomb(const KeyState& previous_keys, Round& round){
+	if(upgrade.state && round.get_shot(upgrade_handle) == nullptr) return true;
 
-	if(owner_state.key_state.shoot && !previous_keys.shoot) {
-		if(state.state){
-			round.remove_shot(shot);
+	if(state.key_state.shoot && !previous_keys.shoot) {
+		if(upgrade.state){
+			round.remove_shot(upgrade_handle);
 			return true;
 		} else {
-			state.state = 1;
-			shot = round.add_shot(make_unique<Shot>(ShotDetails(
-				owner_state.position + owner_state.direction * CANNON_LENGTH,
-				owner_state.direction * BOMB_SPEED,
+			upgrade.state = 1;
+			upgrade_handle = round.add_shot(round.create<Shot>(ShotDetails(
+				state.position + state.direction * CANNON_LENGTH,
+				state.direction * BOMB_SPEED,
 				BOMB_RADIUS, -1, ShotDetails::Type::ROUND,
-				owner
+				index
 			)));
 		}
 	}
 	return false;
 }
 
-RemoteControlMissileManager::RemoteControlMissileManager(int owner) :
-	AppliedUpgrade({
-		.type = Upgrade::Type::RC_MISSILE,
-		.state = 0,
-		.timer = 0
-	}),
-	controller(nullptr),
-	owner(owner) {
-}
 
-bool RemoteControlMissileManager::allow_moving() const {
-	return state.state == 0;
-}
-
-bool RemoteControlMissileManager::step(
-	const TankState& owner_state,
-	const KeyState& previous_keys,
-	Round& round
-	){
-	
-	if(state.state){
-		if(round.get_missile(missile) == nullptr) return true;
-		controller->steer((owner_state.key_state.right ? 1 : 0) - (owner_state.key_state.left ? 1 : 0));
+bool Tank::step_remote_missile(const KeyState& previous_keys, Round& round){
+	if(upgrade.state){
+		auto missile = round.get_missile(upgrade_handle);
+		if(missile == nullptr) return true;
+		static_cast<RemoteMissileController&>(missile->get_controller()).steer(
+			(state.key_state.right ? 1 : 0) - (state.key_state.left ? 1 : 0)
+		);
 	}
 	else{
-		if(owner_state.key_state.shoot && !previous_keys.shoot){
-			state.state = 1;
-			auto missile_control = make_unique<RemoteMissileController>();
-			controller = missile_control.get();
-			missile = round.add_missile(make_unique<Missile>(
+		if(state.key_state.shoot && !previous_keys.shoot){
+			upgrade.state = 1;
+			upgrade_handle = round.add_missile(round.create<Missile>(
 				MissileDetails(
-					owner_state.position + owner_state.direction * MISSILE_LAUNCHER_LENGTH,
-					owner_state.direction,
-					owner
+					state.position + state.direction * MISSILE_LAUNCHER_LENGTH,
+					state.direction,
+					state.heading,
+					index
 				),
-				move(missile_control)
+				round.create<RemoteMissileController>()
 			));
 		}
 	}
@@ -556,33 +699,22 @@ bool RemoteControlMissileManager::step(
 	return false;
 }
 
-HomingMissileManager::HomingMissileManager(int owner) :
-	AppliedUpgrade({
-		.type = Upgrade::Type::HOMING_MISSILE,
-		.state = 0,
-		.timer = 0
-	}),
-	owner(owner) {
-}
 
-bool HomingMissileManager::step(
-	const TankState& owner_state,
-	const KeyState& previous_keys,
-	Round& round
-	){
-	if(state.state){
-		return round.get_missile(missile) == nullptr;
+bool Tank::step_homing_missile(const KeyState& previous_keys, Round& round){
+	if(upgrade.state){
+		return round.get_missile(upgrade_handle) == nullptr;
 	}
 	else{
-		if(owner_state.key_state.shoot && !previous_keys.shoot){
-			state.state = 1;
-			missile = round.add_missile(make_unique<Missile>(
+		if(state.key_state.shoot && !previous_keys.shoot){
+			upgrade.state = 1;
+			upgrade_handle = round.add_missile(round.create<Missile>(
 				MissileDetails(
-					owner_state.position + owner_state.direction * MISSILE_LAUNCHER_LENGTH,
-					owner_state.direction,
-					owner
+					state.position + state.direction * MISSILE_LAUNCHER_LENGTH,
+					state.direction,
+					state.heading,
+					index
 				),
-				make_unique<HomingMissileController>(round.get_maze_map())
+				round.create<HomingMissileController>(round.get_maze_map())
 			));
 		}
 	}
@@ -590,52 +722,32 @@ bool HomingMissileManager::step(
 	return false;
 }
 
-MineManager::MineManager(int owner) : 
-	AppliedUpgrade({
-		.type = Upgrade::Type::MINES,
-		.state = 0,
-		.timer = 0
-	}),
-	owner(owner),
-	remaining_mines(3) {
-	
-}
 
-bool MineManager::step(
-	const TankState& owner_state,
-	const KeyState& previous_keys,
-	Round& round
-){
-	if(owner_state.key_state.shoot && !previous_keys.shoot){
-		round.add_mine(make_unique<Mine>(MineDetails(
-			owner_state.position - owner_state.direction * MINE_DISTANCE,
-			owner_state.direction,
-			owner
+
+bool Tank::step_mines(const KeyState& previous_keys, Round& round){
+	if(state.key_state.shoot && !previous_keys.shoot){
+		round.add_mine(round.create<Mine>(MineDetails(
+			state.position - state.direction * MINE_DISTANCE,
+			state.direction,
+			index
 		)));
 		remaining_mines--;
 	}
 	return remaining_mines == 0;
 }
 
-DeathRayManager::DeathRayManager(int owner, Game& game) :
-	AppliedUpgrade({
-		.type = Upgrade::Type::DEATH_RAY,
-		.state = 0,
-		.timer = 0,
-	}),
-	owner(owner),
-	game(game) {}
-	
+
 const Number DEATH_RAY_STEP = Number(3)/10;
 const Number DEATH_RAY_MAX_TURN = Number(1)/20;
 
-vector<Point> DeathRayManager::get_path(const TankState& owner_state){
+vector<Point> Tank::get_death_ray_path() const{
 	vector<Point> path;
 	
-	path.push_back(owner_state.position + owner_state.direction * CANNON_LENGTH);
-	Point direction = owner_state.direction;
+	path.push_back(state.position + state.direction * CANNON_LENGTH);
+	Point direction = state.direction;
 	
-	auto tanks = game.get_states();
+	const auto& tanks = game.get_tank_states();
+	bool homing = true;
 	
 	while(
 		path.back().x > 0 && path.back().x < game.get_maze().get_w() &&
@@ -645,10 +757,10 @@ vector<Point> DeathRayManager::get_path(const TankState& owner_state){
 		
 		Number turn = 0, weight = 0;
 		bool first = true;
-		for(int i = 0; i < tanks.size(); i++){
-			if(i == owner) continue;
-			if(!tanks[i].state.alive) continue;
-			Point way = tanks[i].state.position - path.back();
+		for(int i = 0; homing && i < tanks.size(); i++){
+			if(i == index) continue;
+			if(!tanks[i]->alive) continue;
+			Point way = tanks[i]->position - path.back();
 			
 			Number distance_sqr = dot(way, way);
 			Number distance_forward = dot(way, direction);
@@ -663,6 +775,8 @@ vector<Point> DeathRayManager::get_path(const TankState& owner_state){
 			}
 			first = false;
 		}
+		// Once every tank is behind the ray it goes straight until it leaves the maze
+		if(first) homing = false;
 		
 		if(turn > DEATH_RAY_MAX_TURN) turn = DEATH_RAY_MAX_TURN;
 		if(turn < -DEATH_RAY_MAX_TURN) turn = -DEATH_RAY_MAX_TURN;
@@ -673,95 +787,113 @@ vector<Point> DeathRayManager::get_path(const TankState& owner_state){
 	return path;
 }
 
-bool DeathRayManager::step(
-	const TankState& owner_state,
-	const KeyState& previous_keys,
-	Round& round
-){
-	if(state.timer > 0) state.timer--;
+bool Tank::step_death_ray(const KeyState& previous_keys, Round& round){
+	if(upgrade.timer > 0) upgrade.timer--;
 	else{
-		switch(state.state){
+		switch(upgrade.state){
 		case 0:
-			if(owner_state.key_state.shoot && !previous_keys.shoot){
-				state.state = 1;
-				state.timer = DEATH_RAY_LOAD_TIME;
+			if(state.key_state.shoot && !previous_keys.shoot){
+				upgrade.state = 1;
+				upgrade.timer = DEATH_RAY_LOAD_TIME;
 			}
 			break;
 		case 1:
-			state.state = 2;
-			death_ray = round.add_death_ray(make_unique<DeathRay>(DeathRayPath(
-				get_path(owner_state),
-				owner
+			upgrade.state = 2;
+			upgrade_handle = round.add_death_ray(round.create<DeathRay>(DeathRayPath(
+				get_death_ray_path(),
+				index
 			)));
 			break;
 		case 2:
-			if(round.get_death_ray(death_ray) == nullptr) return true;
+			if(round.get_death_ray(upgrade_handle) == nullptr) return true;
 			break;
 		}
 	}
 	return false;
 }
-bool DeathRayManager::allow_moving() const{
-	return state.state == 0;
+
+
+bool Tank::step_upgrade(const KeyState& previous_keys, Round& round){
+	switch(upgrade.type){
+	case Upgrade::Type::GATLING:
+		return step_gatling(previous_keys, round);
+	case Upgrade::Type::LASER:
+		return step_laser(previous_keys, round);
+	case Upgrade::Type::BOMB:
+		return step_bomb(previous_keys, round);
+	case Upgrade::Type::RC_MISSILE:
+		return step_remote_missile(previous_keys, round);
+	case Upgrade::Type::HOMING_MISSILE:
+		return step_homing_missile(previous_keys, round);
+	case Upgrade::Type::MINES:
+		return step_mines(previous_keys, round);
+	case Upgrade::Type::DEATH_RAY:
+		return step_death_ray(previous_keys, round);
+	}
+	return true;
+}
+
+bool Tank::upgrade_allows_moving() const{
+	switch(upgrade.type){
+	case Upgrade::Type::RC_MISSILE:
+	case Upgrade::Type::DEATH_RAY:
+		return upgrade.state == 0;
+	default:
+		return true;
+	}
 }
 
 Tank::Tank(Game& game, int index) :
 	game(game),
 	index(index),
-	shot_manager(make_unique<ShotManager>(index, game)),
-	upgrade(nullptr),
+	has_upgrade(false),
+	upgrade({
+		.type = Upgrade::Type::GATLING,
+		.state = 0,
+		.timer = 0
+	}),
+	upgrade_handle(-1),
+	remaining_mines(0),
 	state(
 		{ .x = -1, .y = -1 } /*position*/,
 		{ .x = 1, .y = 0 } /*direction*/,
+		0 /*heading*/,
 		KeyState(),
 		true /*active*/,
 		true /*alive*/
 	) {
 
+	shots.reserve(MAX_SHOTS);
 }
 
 const TankState& Tank::get_state() const{
 	return state;
 }
-const unique_ptr<AppliedUpgrade>& Tank::get_upgrade() const{
-	return upgrade;
+const TankUpgradeState* Tank::get_upgrade() const{
+	return has_upgrade ? &upgrade : nullptr;
 }
 void Tank::set_upgrade(Upgrade::Type type){
-	switch(type){
-	case Upgrade::Type::GATLING:
-		upgrade = make_unique<GatlingShotManager>(index);
-		break;
-	case Upgrade::Type::LASER:
-		upgrade = make_unique<LaserManager>(index);
-		break;
-	case Upgrade::Type::BOMB:
-		upgrade = make_unique<BombManager>(index, game);
-		break;
-	case Upgrade::Type::RC_MISSILE:
-		upgrade = make_unique<RemoteControlMissileManager>(index);
-		break;
-	case Upgrade::Type::HOMING_MISSILE:
-		upgrade = make_unique<HomingMissileManager>(index);
-		break;
-	case Upgrade::Type::MINES:
-		upgrade = make_unique<MineManager>(index);
-		break;
-	case Upgrade::Type::DEATH_RAY:
-		upgrade = make_unique<DeathRayManager>(index, game);
-		break;
-	}
+	has_upgrade = true;
+	upgrade = {
+		.type = type,
+		.state = 0,
+		.timer = type == Upgrade::Type::GATLING ? -GATLING_START_TIME : 0
+	};
+	upgrade_handle = -1;
+	remaining_mines = type == Upgrade::Type::MINES ? MINE_COUNT : 0;
 }
 
 void Tank::reset(int maze_w, int maze_h){
 	state.position.x = Number(2 * rand_range(0, maze_w) + 1) / 2;
 	state.position.y = Number(2 * rand_range(0, maze_h) + 1) / 2;
 
-	state.direction = random_discrete_direction();
+	state.heading = random_heading();
+	state.direction = get_heading_direction(state.heading);
 	state.key_state = KeyState();
 	pending_keys.clear();
 
-	shot_manager->reset();
-	upgrade = nullptr;
+	shots.clear();
+	has_upgrade = false;
 
 	state.alive = true;
 }
@@ -778,26 +910,28 @@ bool Tank::can_advance() const{
 	return !state.active || !pending_keys.empty();
 }
 void Tank::advance(Round& round){
-	auto previous_keys = state.key_state;
+	KeyState key_state;
 	if(state.active){
-		state.key_state = pending_keys.front();
+		key_state = pending_keys.front();
 		pending_keys.pop_front();
 	}
-	else{
-		state.key_state = KeyState();
-	}
+	advance(round, key_state);
+}
+void Tank::advance(Round& round, const KeyState& key_state){
+	auto previous_keys = state.key_state;
+	state.key_state = key_state;
 
 	if(!state.alive) return;
 
-	if(upgrade != nullptr){
-		if(upgrade->allow_moving()){
+	if(has_upgrade){
+		if(upgrade_allows_moving()){
 			advance_tank(state, game.get_maze());
 		}
-		if(upgrade->step(state, previous_keys, round)) upgrade = nullptr;
+		if(step_upgrade(previous_keys, round)) has_upgrade = false;
 	}
 	else{
 		advance_tank(state, game.get_maze());
-		shot_manager->step(state, previous_keys, round);
+		step_shots(previous_keys, round);
 	}
 }
 
@@ -805,13 +939,62 @@ void Tank::kill(){
 	state.alive = false;
 }
 
+void Tank::on_shot_removed(int shot_id, Round& round){
+	for(int i = 0; i < shots.size(); i++){
+		if(shots[i] == shot_id){
+			shots[i] = shots.back();
+			shots.pop_back();
+			break;
+		}
+	}
+	if(has_upgrade && upgrade.type == Upgrade::Type::BOMB && upgrade.state && shot_id == upgrade_handle){
+		round.explode(round.get_shot(shot_id)->get_state().position);
+	}
+}
+
+void Tank::serialize(ostream& output) const{
+	serialize_value(output, state);
+	serialize_value(output, shots);
+
+	serialize_value(output, has_upgrade);
+	if(has_upgrade){
+		serialize_value(output, (unsigned char)upgrade.type);
+		serialize_value(output, upgrade.state);
+		serialize_value(output, upgrade.timer);
+		serialize_value(output, upgrade_handle);
+		serialize_value(output, remaining_mines);
+	}
+}
+void Tank::load(istream& input, Round& round){
+	state = deserialize_value<TankState>(input);
+	pending_keys.clear();
+	shots = deserialize_value<vector<int>>(input);
+
+	has_upgrade = deserialize_value<bool>(input);
+	if(has_upgrade){
+		upgrade.type = (Upgrade::Type)deserialize_value<unsigned char>(input);
+		upgrade.state = deserialize_value<int>(input);
+		upgrade.timer = deserialize_value<int>(input);
+		upgrade_handle = deserialize_value<int>(input);
+		remaining_mines = deserialize_value<int>(input);
+	}
+}
+void Tank::hash(StateHash& hash) const{
+	state.hash(hash);
+	for(int shot: shots) hash.add(shot);
+
+	hash.add((int)shots.size(), has_upgrade);
+	if(has_upgrade){
+		hash.add(upgrade.type, upgrade.state);
+		hash.add(upgrade.timer, upgrade_handle);
+		hash.add(remaining_mines);
+	}
+}
+
 bool Projectile::advance(Game& game){
 	vector<int> killed_tanks;
-	
-	vector<const TankState*> tanks;
-	for(const auto& tank: game.get_states()) tanks.push_back(&tank.state);
 
-	bool finished = step(game.get_maze(), tanks, killed_tanks);
+	bool finished = step(game.get_maze(), game.get_tank_states(), killed_tanks);
 
 	for(int tank: killed_tanks){
 		game.kill_tank(tank);
@@ -845,6 +1028,22 @@ const vector<TimePoint>& Shot::get_path() const{
 	return path;
 }
 
+void Shot::serialize(ostream& output) const{
+	serialize_value(output, state);
+	serialize_value(output, path);
+	serialize_value(output, ignored_tank);
+}
+Shot Shot::deserialize(istream& input){
+	Shot shot(deserialize_value<ShotDetails>(input));
+	shot.path = deserialize_value<vector<TimePoint>>(input);
+	shot.ignored_tank = deserialize_value<int>(input);
+	return shot;
+}
+void Shot::hash(StateHash& hash) const{
+	state.hash(hash);
+	hash.add(ignored_tank);
+}
+
 Shrapnel::Shrapnel(const ShrapnelDetails& details, const Maze& maze) :
 	state({
 		.details = details,
@@ -852,6 +1051,8 @@ Shrapnel::Shrapnel(const ShrapnelDetails& details, const Maze& maze) :
 		.timer = 0,
 	}) {}
 
+Shrapnel::Shrapnel(const ShrapnelState& state) : state(state) {}
+
 bool Shrapnel::step(
 	const Maze& maze, const vector<const TankState*>& tanks,
 	vector<int>& killed_tanks
@@ -875,6 +1076,35 @@ const ShrapnelState& Shrapnel::get_state() const{
 	return state;
 }
 
+void Shrapnel::serialize(ostream& output) const{
+	serialize_value(output, state.details);
+	serialize_value(output, state.collision);
+	serialize_value(output, state.timer);
+}
+Shrapnel Shrapnel::deserialize(istream& input){
+	auto details = deserialize_value<ShrapnelDetails>(input);
+	auto collision = deserialize_value<Number>(input);
+	auto timer = deserialize_value<int>(input);
+
+	return Shrapnel({
+		.details = details,
+		.collision = collision,
+		.timer = timer
+	});
+}
+
+MissileController::~MissileController() {}
+
+ArenaPtr<MissileController> MissileController::deserialize(istream& input, Round& round){
+	switch((MissileController::Type)deserialize_value<unsigned char>(input)){
+	case MissileController::Type::REMOTE:
+		return round.create<RemoteMissileController>(RemoteMissileController::deserialize(input));
+	case MissileController::Type::HOMING:
+	default:
+		return round.create<HomingMissileController>(HomingMissileController::deserialize(input, round.get_maze_map()));
+	}
+}
+
 RemoteMissileController::RemoteMissileController() : turn_state(0) {}
 
 int RemoteMissileController::get_turn_direction() const {
@@ -891,12 +1121,29 @@ void RemoteMissileController::steer(int direction){
 	turn_state = direction;
 }
 
+void RemoteMissileController::serialize(ostream& output) const{
+	serialize_value(output, (unsigned char)MissileController::Type::REMOTE);
+	serialize_value(output, turn_state);
+}
+RemoteMissileController RemoteMissileController::deserialize(istream& input){
+	RemoteMissileController controller;
+	controller.turn_state = deserialize_value<int>(input);
+	return controller;
+}
+void RemoteMissileController::hash(StateHash& hash) const{
+	hash.add(MissileController::Type::REMOTE, turn_state);
+}
+
 const int HOMING_TIME = 60;
 
 HomingMissileController::HomingMissileController(const MazeMap& maze_map) :
 	maze_map(maze_map),
 	timer(HOMING_TIME),
-	target(-1), turn_state(0) {}
+	target(-1), turn_state(0),
+	routed(false),
+	route_distance(-1),
+	waypoint({ .x = 0, .y = 0 }),
+	missile_cell(-1, -1) {}
 
 int HomingMissileController::get_turn_direction() const{
 	return turn_state;
@@ -910,12 +1157,52 @@ void HomingMissileController::step(const MissileDetails& missile, const vector<c
 		return;
 	}
 	
-	turn_state = target_missile_turn(maze_map, missile, tanks, target);
+	
+	// A tank in the missile's own cell is chased by its exact position, so that route is never reused
+	bool changed = !routed || route_distance == 0;
+	pair<int, int> current_cell(missile.position.x, missile.position.y);
+	if(current_cell != missile_cell){
+		missile_cell = current_cell;
+		changed = true;
+	}
+	tank_cells.resize(tanks.size(), { -1, -1 });
+	for(int i = 0; i < tanks.size(); i++){
+		pair<int, int> cell(-1, -1);
+		if(tanks[i]->alive) cell = { tanks[i]->position.x, tanks[i]->position.y };
+		if(cell != tank_cells[i]){
+			tank_cells[i] = cell;
+			changed = true;
+		}
+	}
+	
+	if(changed){
+		target = get_missile_target(maze_map, missile, tanks, waypoint, route_distance);
+		routed = true;
+	}
+	turn_state = target == -1 ? 0 : get_missile_turn(missile, waypoint);
+}
+
+void HomingMissileController::serialize(ostream& output) const{
+	serialize_value(output, (unsigned char)MissileController::Type::HOMING);
+	serialize_value(output, timer);
+	serialize_value(output, target);
+	serialize_value(output, turn_state);
+}
+HomingMissileController HomingMissileController::deserialize(istream& input, const MazeMap& maze_map){
+	HomingMissileController controller(maze_map);
+	controller.timer = deserialize_value<int>(input);
+	controller.target = deserialize_value<int>(input);
+	controller.turn_state = deserialize_value<int>(input);
+	return controller;
+}
+void HomingMissileController::hash(StateHash& hash) const{
+	hash.add(MissileController::Type::HOMING, timer);
+	hash.add(target, turn_state);
 }
 
 const int MISSILE_TTL = 1200;
 
-Missile::Missile(MissileDetails&& details, unique_ptr<MissileController>&& controller) :
+Missile::Missile(MissileDetails&& details, ArenaPtr<MissileController>&& controller) :
 	state(move(details)),
 	controller(move(controller)),
 	timer(MISSILE_TTL),
@@ -953,6 +1240,28 @@ const MissileDetails& Missile::get_state() const{
 const int Missile::get_target() const{
 	return controller->get_target();
 }
+MissileController& Missile::get_controller() const{
+	return *controller;
+}
+
+void Missile::serialize(ostream& output) const{
+	serialize_value(output, state);
+	controller->serialize(output);
+	serialize_value(output, ignoring_owner);
+	serialize_value(output, timer);
+}
+Missile Missile::deserialize(istream& input, Round& round){
+	auto state = deserialize_value<MissileDetails>(input);
+	Missile missile(move(state), MissileController::deserialize(input, round));
+	missile.ignoring_owner = deserialize_value<bool>(input);
+	missile.timer = deserialize_value<int>(input);
+	return missile;
+}
+void Missile::hash(StateHash& hash) const{
+	state.hash(hash);
+	controller->hash(hash);
+	hash.add(ignoring_owner, timer);
+}
 
 const int MINE_TIME = 60;
 
@@ -964,7 +1273,7 @@ Mine::Mine(MineDetails&& details) :
 
 }
 
-bool Mine::step(const vector<TankCompleteState>& tanks){
+bool Mine::step(const vector<const TankState*>& tanks){
 	if(timer == 0){
 		if(started) return true;
 		started = true;
@@ -977,7 +1286,7 @@ bool Mine::step(const vector<TankCompleteState>& tanks){
 	bool previously_pressed = pressed;
 	pressed = false;
 	for(const auto tank: tanks){
-		if(check_mine_collision(details, tank.state)){
+		if(check_mine_collision(details, *tank)){
 			pressed = true;
 		}
 	}
@@ -998,9 +1307,30 @@ MineState Mine::get_state() const{
 	return MineState::INACTIVE;
 }
 
+void Mine::serialize(ostream& output) const{
+	serialize_value(output, details);
+	serialize_value(output, timer);
+	serialize_flags(output, started, pressed);
+}
+Mine Mine::deserialize(istream& input){
+	Mine mine(deserialize_value<MineDetails>(input));
+	mine.timer = deserialize_value<int>(input);
+	auto [started, pressed] = deserialize_flags<2>(input);
+	mine.started = started;
+	mine.pressed = pressed;
+	return mine;
+}
+void Mine::hash(StateHash& hash) const{
+	details.hash(hash);
+	hash.add(timer, started | pressed << 1);
+}
+
 const int DEATH_RAY_TTL = 30;
 
-DeathRay::DeathRay(DeathRayPath&& path) : path(path), timer(DEATH_RAY_TTL) {}
+DeathRay::DeathRay(DeathRayPath&& path) :
+	path(path),
+	segments(compile_death_ray(this->path.path)),
+	timer(DEATH_RAY_TTL) {}
 
 bool DeathRay::step(
 	const Maze& maze, const vector<const TankState*>& tanks,
@@ -1011,7 +1341,7 @@ bool DeathRay::step(
 
 	for(int i = 0; i < tanks.size(); i++){
 		if(i == path.owner) continue;
-		if(check_death_ray_collision(path.path, *tanks[i])){
+		if(check_death_ray_collision(segments, *tanks[i])){
 			killed_tanks.push_back(i);
 		}
 	}
@@ -1024,3 +1354,17 @@ const DeathRayPath& DeathRay::get_path() const{
 int DeathRay::get_timer() const{
 	return timer;
 }
+
+void DeathRay::serialize(ostream& output) const{
+	serialize_value(output, path);
+	serialize_value(output, timer);
+}
+DeathRay DeathRay::deserialize(istream& input){
+	DeathRay death_ray(deserialize_value<DeathRayPath>(input));
+	death_ray.timer = deserialize_value<int>(input);
+	return death_ray;
+}
+void DeathRay::hash(StateHash& hash) const{
+	path.hash(hash);
+	hash.add(timer);
+}
@@ -6,10 +6,16 @@
 #include <set>
 #include <map>
 #include <deque>
+#include <iostream>
 
 #include "maze.h"
+#include "logic.h"
+#include "tick_profile.h"
 
 #include "../../utils/numbers.h"
+#include "../../utils/slot_map.h"
+#include "../../utils/arena.h"
+#include "../../utils/state_hash.h"
 
 #include "../data/game_objects.h"
 #include "../interface/game_view.h"
@@ -21,7 +27,6 @@ class Game;
 class Tank;
 class Shot;
 class Round;
-class WeaponManager;
 class RemoteMissileController;
 
 class Game : public GameView, public GameAdvancer, public GameObserverHub {
@@ -29,13 +34,29 @@ class Game : public GameView, public GameAdvancer, public GameObserverHub {
 	const vector<Upgrade::Type> allowed_upgrades;
 	unique_ptr<Round> round;
 	int round_num;
+	size_t arena_peak_bytes;
+	uint64_t state_hash;
 
 	vector<Tank> tanks;
+	vector<const TankState*> tank_states;
+
+	// Storage behind the GameView spans, rebuilt once the world changes
+	vector<TankCompleteState> states_buffer;
+	vector<ShotPath> shots_buffer;
+	vector<MissileState> missiles_buffer;
+	vector<const ShrapnelState*> shrapnels_buffer;
+	vector<MineCompleteState> mines_buffer;
+	vector<DeathRayState> death_rays_buffer;
+
+#ifdef TICK_PROFILING
+	TickProfile tick_profile;
+#endif
 
 	void new_round();
+	void update_views();
 
 	bool can_step() const;
-	void step();
+	void step(const KeyState* keys);  // Without keys every tank takes its queued input
 public:
 	Game(
 		MazeGeneration maze_generation,
@@ -45,169 +66,45 @@ public:
 
 	PlayerInterface& get_player_interface(int player);
 
+	MazeGeneration get_maze_generation() const;
+	const vector<Upgrade::Type>& get_allowed_upgrades() const;
+
 	int get_round() const;
 	const Maze& get_maze() const;
-	vector<TankCompleteState> get_states() const;
-	vector<ShotPath> get_shots() const;
-	vector<MissileState> get_missiles() const;
-	vector<const ShrapnelState*> get_shrapnels() const;
-	vector<MineCompleteState> get_mines() const;
-	vector<DeathRayState> get_death_rays() const;
+	const MazeMap& get_maze_map() const;
+	Span<TankCompleteState> get_states() const;
+	Span<ShotPath> get_shots() const;
+	Span<MissileState> get_missiles() const;
+	Span<const ShrapnelState*> get_shrapnels() const;
+	Span<MineCompleteState> get_mines() const;
+	Span<DeathRayState> get_death_rays() const;
 	const set<unique_ptr<Upgrade>>& get_upgrades() const;
 
-	void advance();
-	void allow_step();
-
-	void kill_tank(int index);
-	void upgrade_tank(int index, Upgrade::Type type);
-};
-
-class WeaponManager{
-public:
-	WeaponManager();
-	WeaponManager(const WeaponManager&) = delete;
-	WeaponManager(WeaponManager&&) = delete;
-	WeaponManager& operator=(const WeaponManager&) = delete;
-	WeaponManager& operator=(WeaponManager&&) = delete;
-	virtual ~WeaponManager();
-
-	virtual bool step(
-		const TankState& owner_state,
-		const KeyState& previous_keys,
-		Round& round
-	) = 0;
-	virtual void reset() = 0;
-};
-
-class ShotManager : public WeaponManager, public GameObserver{
-	Game& game;
-	const int owner;
-	set<int> shots;
-public:
-	ShotManager(int owner, Game& game);
-	~ShotManager();
-
-	bool step(
-		const TankState& owner_state,
-		const KeyState& previous_keys,
-		Round& round
-	);
-	void reset();
-
-	void on_shot_removed(int shot_id);
-};
-
-
-class AppliedUpgrade : public WeaponManager{
-protected:
-	TankUpgradeState state;
-public:
-	AppliedUpgrade(TankUpgradeState state);
-
-	virtual bool allow_moving() const;
-	const TankUpgradeState& get_state() const;
-	virtual void reset();
-};
-
-class GatlingShotManager : public AppliedUpgrade{
-	const int owner;
-public:
-	GatlingShotManager(int owner);
-	
-	bool step(
-		const TankState& owner_state,
-		const KeyState& previous_keys,
-		Round& round
-	);
-};
-
-class LaserManager : public AppliedUpgrade{
-	const int owner;
-public:
-	LaserManager(int owner);
-	
-	bool step(
-		const TankState& owner_state,
-		const KeyState& previous_keys,
-		Round& round
-	);
-};
+	const vector<const TankState*>& get_tank_states() const;
 
-class BombManager : public AppliedUpgrade, public GameObserver{
-	Game& game;
-	Round* round;
-	const int owner;
-	int shot;
-public:
-	BombManager(int owner, Game& game);
-	~BombManager();
-	
-	bool step(
-		const TankState& owner_state,
-		const KeyState& previous_keys,
-		Round& round
-	);
+	const ArenaStats& get_arena_stats() const;
+	size_t get_arena_peak_bytes() const;
 
-	void on_shot_removed(int shot_id);
-};
+	// Chained over every tick so far, equal on every peer that simulated the same ticks
+	uint64_t get_state_hash() const;
 
-class RemoteControlMissileManager : public AppliedUpgrade{
-	const int owner;
-	int missile;
-	RemoteMissileController* controller;
-public:
-	RemoteControlMissileManager(int owner);
-	
-	bool step(
-		const TankState& owner_state,
-		const KeyState& previous_keys,
-		Round& round
-	);
-	
-	bool allow_moving() const;
-};
-
-class HomingMissileManager : public AppliedUpgrade{
-	const int owner;
-	int missile;
-public:
-	HomingMissileManager(int owner);
-	
-	bool step(
-		const TankState& owner_state,
-		const KeyState& previous_keys,
-		Round& round
-	);
-};
+#ifdef TICK_PROFILING
+	TickProfile& get_tick_profile();
+	const TickProfile& get_tick_profile() const;
+#endif
 
-class MineManager : public AppliedUpgrade{
-	const int owner;
-	int remaining_mines;
-public:
-	MineManager(int owner);
-	
-	bool step(
-		const TankState& owner_state,
-		const KeyState& previous_keys,
-		Round& round
-	);
-};
+	void advance();
+	void allow_step();
+	// Steps once with a key state for every tank, bypassing the input queued through PlayerInterface
+	void advance_with(Span<KeyState> keys);
 
-class DeathRayManager : public AppliedUpgrade{
-	const int owner;
-	Game& game;
-	int death_ray;
+	void kill_tank(int index);
+	void upgrade_tank(int index, Upgrade::Type type);
+	const TankUpgradeState* get_tank_upgrade(int index) const;
+	void notify_shot_removed(int owner, int shot_id);
 
-	vector<Point> get_path(const TankState& owner_state);
-public:
-	DeathRayManager(int owner, Game& game);
-	
-	bool step(
-		const TankState& owner_state,
-		const KeyState& previous_keys,
-		Round& round
-	);
-	bool allow_moving() const;
+	void serialize(ostream& output) const;
+	void load(istream& input);
 };
 
 class Tank : public PlayerInterface{
@@ -215,15 +112,34 @@ class Tank : public PlayerInterface{
 	const int index;
 
 	TankState state;
-	unique_ptr<ShotManager> shot_manager;
-	unique_ptr<AppliedUpgrade> upgrade;
+	vector<int> shots;  // Regular shots in flight
+
+	// Weapon state is stored inline and dispatched on the upgrade type
+	bool has_upgrade;
+	TankUpgradeState upgrade;
+	int upgrade_handle;  // Handle of the fired bomb, missile or death ray
+	int remaining_mines;  // Mines left to lay for MINES
 		
 	deque<KeyState> pending_keys;
+
+	void step_shots(const KeyState& previous_keys, Round& round);
+	bool step_upgrade(const KeyState& previous_keys, Round& round);
+	bool upgrade_allows_moving() const;
+
+	bool step_gatling(const KeyState& previous_keys, Round& round);
+	bool step_laser(const KeyState& previous_keys, Round& round);
+	bool step_bomb(const KeyState& previous_keys, Round& round);
+	bool step_remote_missile(const KeyState& previous_keys, Round& round);
+	bool step_homing_missile(const KeyState& previous_keys, Round& round);
+	bool step_mines(const KeyState& previous_keys, Round& round);
+	bool step_death_ray(const KeyState& previous_keys, Round& round);
+
+	vector<Point> get_death_ray_path() const;
 public:
 	Tank(Game& game, int index);
 
 	const TankState& get_state() const;
-	const unique_ptr<AppliedUpgrade>& get_upgrade() const;
+	const TankUpgradeState* get_upgrade() const;
 	void reset(int maze_w, int maze_h);
 	void set_upgrade(Upgrade::Type type);
 
@@ -232,8 +148,14 @@ public:
 
 	bool can_advance() const;
 	void advance(Round& round);
+	void advance(Round& round, const KeyState& key_state);
 
 	void kill();
+	void on_shot_removed(int shot_id, Round& round);
+
+	void serialize(ostream& output) const;
+	void load(istream& input, Round& round);
+	void hash(StateHash& hash) const;
 };
 
 class Projectile{
@@ -260,10 +182,16 @@ public:
 
 	const ShotDetails& get_state() const;
 	const vector<TimePoint>& get_path() const;
+
+	void serialize(ostream& output) const;
+	static Shot deserialize(istream& input);
+	void hash(StateHash& hash) const;
 };
 
 class Shrapnel : public Projectile{
 	ShrapnelState state;
+
+	Shrapnel(const ShrapnelState& state);
 protected:
 	bool step(
 		const Maze& maze, const vector<const TankState*>& tanks,
@@ -273,13 +201,27 @@ public:
 	Shrapnel(const ShrapnelDetails& details, const Maze& maze);
 	
 	const ShrapnelState& get_state() const;
+
+	void serialize(ostream& output) const;
+	static Shrapnel deserialize(istream& input);
 };
 
 class MissileController{
 public:
+	enum class Type : unsigned char{
+		REMOTE = 0,
+		HOMING = 1
+	};
+
 	virtual int get_turn_direction() const = 0;
 	virtual int get_target() const = 0;
 	virtual void step(const MissileDetails& missile, const vector<const TankState*>& tanks) = 0;
+
+	virtual ~MissileController();
+
+	virtual void serialize(ostream& output) const = 0;
+	static ArenaPtr<MissileController> deserialize(istream& input, Round& round);
+	virtual void hash(StateHash& hash) const = 0;
 };
 
 class RemoteMissileController : public MissileController{
@@ -292,23 +234,38 @@ public:
 	void step(const MissileDetails& missile, const vector<const TankState*>& tanks);
 	
 	void steer(int direction);
+
+	void serialize(ostream& output) const;
+	static RemoteMissileController deserialize(istream& input);
+	void hash(StateHash& hash) const;
 };
 
 class HomingMissileController : public MissileController{
 	int timer;
 	int target, turn_state;
 	const MazeMap& maze_map;
+
+	// Route cache, rebuilt only when the missile or a tank changes cell
+	bool routed;
+	int route_distance;
+	Point waypoint;
+	pair<int, int> missile_cell;
+	vector<pair<int, int>> tank_cells;
 public:
 	HomingMissileController(const MazeMap& maze_map);
 
 	int get_turn_direction() const;
 	int get_target() const;
 	void step(const MissileDetails& missile, const vector<const TankState*>& tanks);
+
+	void serialize(ostream& output) const;
+	static HomingMissileController deserialize(istream& input, const MazeMap& maze_map);
+	void hash(StateHash& hash) const;
 };
 
 class Missile : public Projectile{
 	MissileDetails state;
-	unique_ptr<MissileController> controller;
+	ArenaPtr<MissileController> controller;
 	bool ignoring_owner;
 	int timer;
 protected:
@@ -317,10 +274,15 @@ protected:
 		vector<int>& killed_tanks
 	);
 public:
-	Missile(MissileDetails&& details, unique_ptr<MissileController>&& controller);
+	Missile(MissileDetails&& details, ArenaPtr<MissileController>&& controller);
 	
 	const MissileDetails& get_state() const;
 	const int get_target() const;
+	MissileController& get_controller() const;
+
+	void serialize(ostream& output) const;
+	static Missile deserialize(istream& input, Round& round);
+	void hash(StateHash& hash) const;
 };
 
 class Mine{
@@ -330,14 +292,19 @@ class Mine{
 public:
 	Mine(MineDetails&& details);
 	
-	bool step(const vector<TankCompleteState>& tanks);
+	bool step(const vector<const TankState*>& tanks);
 	
 	const MineDetails& get_details() const;
 	MineState get_state() const;
+
+	void serialize(ostream& output) const;
+	static Mine deserialize(istream& input);
+	void hash(StateHash& hash) const;
 };
 
 class DeathRay : public Projectile{
 	const DeathRayPath path;
+	const vector<DeathRaySegment> segments;
 	int timer;
 protected:
 	bool step(
@@ -349,61 +316,83 @@ public:
 	
 	const DeathRayPath& get_path() const;
 	int get_timer() const;
+
+	void serialize(ostream& output) const;
+	static DeathRay deserialize(istream& input);
+	void hash(StateHash& hash) const;
 };
 
 class Round{
 	Game& game;
 	const vector<Upgrade::Type>& allowed_upgrades;
 
-	int next_id;
-	map<int, unique_ptr<Shot>> shots;
-	set<int> removed_shots;
-	set<unique_ptr<Shrapnel>> shrapnels;
-	map<int, unique_ptr<Missile>> missiles;
-	set<int> removed_missiles;
-	map<int, unique_ptr<Mine>> mines;
-	map<int, unique_ptr<DeathRay>> death_rays;
+	Arena arena;  // Declared before everything allocated from it
+
+	SlotMap<ArenaPtr<Shot>> shots;
+	vector<int> removed_shots;  // In removal order
+	set<ArenaPtr<Shrapnel>> shrapnels;
+	// Shrapnels are too many to hash every tick: their flights never change, so their hashes are summed
+	// as they are added and removed, and the timers are summed by the shrapnel phase of step()
+	uint64_t shrapnels_hash;
+	int shrapnel_timers;
+	SlotMap<ArenaPtr<Missile>> missiles;
+	vector<int> removed_missiles;
+	SlotMap<ArenaPtr<Mine>> mines;
+	SlotMap<ArenaPtr<DeathRay>> death_rays;
 
 	set<unique_ptr<Upgrade>> upgrades;
+	uint64_t upgrades_hash;  // Summed as upgrades are created and taken
 	int upgrade_timer;
 	void create_upgrade();
 
 	const Maze maze;
 	const MazeMap maze_map;
+	uint64_t maze_hash;  // The maze never changes during a round, so it is hashed once
 	
 	void remove_mine(int mine_id);
 public:
 	Round(Game& game, MazeGeneration maze_generation, const vector<Upgrade::Type>& allowed_upgrades);
+	Round(Game& game, const vector<Upgrade::Type>& allowed_upgrades, Maze&& maze);
 
 	const Maze& get_maze() const;
 	const MazeMap& get_maze_map() const;
 
 	void step();
 
-	int add_shot(unique_ptr<Shot>&& shot);
+	template<typename T, typename... Args>
+	ArenaPtr<T> create(Args&&... args){
+		return arena.create<T>(forward<Args>(args)...);
+	}
+	const ArenaStats& get_arena_stats() const;
+
+	int add_shot(ArenaPtr<Shot>&& shot);
 	void remove_shot(int shot_id);
 	Shot* get_shot(int shot_id) const;
 
-	int add_missile(unique_ptr<Missile>&& missile);
+	int add_missile(ArenaPtr<Missile>&& missile);
 	void remove_missile(int missile_id);
 	Missile* get_missile(int missile_id) const;
 	
-	int add_mine(unique_ptr<Mine>&& mine);
+	int add_mine(ArenaPtr<Mine>&& mine);
 	Mine* get_mine(int mine_id) const;
 
-	int add_death_ray(unique_ptr<DeathRay>&& death_ray);
+	int add_death_ray(ArenaPtr<DeathRay>&& death_ray);
 	void remove_death_ray(int death_ray_id);
 	DeathRay* get_death_ray(int death_ray_id) const;
 
-	const map<int, unique_ptr<Shot>>& get_shots() const;
-	const map<int, unique_ptr<Missile>>& get_missiles() const;
-	const map<int, unique_ptr<Mine>>& get_mines() const;
-	const map<int, unique_ptr<DeathRay>>& get_death_rays() const;
+	const SlotMap<ArenaPtr<Shot>>& get_shots() const;
+	const SlotMap<ArenaPtr<Missile>>& get_missiles() const;
+	const SlotMap<ArenaPtr<Mine>>& get_mines() const;
+	const SlotMap<ArenaPtr<DeathRay>>& get_death_rays() const;
 
 	void explode(const Point& source);
-	const set<unique_ptr<Shrapnel>>& get_shrapnels() const;
+	const set<ArenaPtr<Shrapnel>>& get_shrapnels() const;
 	
 	const set<unique_ptr<Upgrade>>& get_upgrades() const;
+
+	void serialize(ostream& output) const;
+	static unique_ptr<Round> deserialize(istream& input, Game& game, const vector<Upgrade::Type>& allowed_upgrades);
+	void hash(StateHash& hash) const;
 };
 
 #endif
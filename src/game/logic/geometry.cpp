@@ -3,10 +3,6 @@
 #include "../../utils/utils.h"
 #include "../../utils/serialization.h"
 
-#include <deque>
-#include <set>
-#include <functional>
-
 #define _USE_MATH_DEFINES
 #include <math.h>
 
@@ -67,23 +63,47 @@ void normalize(Point& point){
 	point /= length(point);
 }
 
-Point random_discrete_direction(){
-	int direction = rand_range(0, TURN_NUM);
-
-	Point result{
-		.x = 1,
-		.y = 0
-	};
-	
-	Point cur {.x = TURN_COS, .y = TURN_SIN};
-	for(int mask = 1; mask < direction; mask <<= 1){
-		if(mask & direction) result = rotate(result, cur);
-		
-		cur = rotate(cur, cur);
+static vector<Point> get_heading_table(){
+	vector<Point> table;
+	for(int heading = 0; heading < TURN_NUM; heading++){
+		table.push_back({
+			.x = cos(2 * M_PI * heading / TURN_NUM),
+			.y = sin(2 * M_PI * heading / TURN_NUM)
+		});
 	}
-	
-	normalize(result);
-	return result;
+	return table;
+}
+
+const vector<Point> HEADING_DIRECTIONS = get_heading_table();
+
+const Point& get_heading_direction(int heading){
+	return HEADING_DIRECTIONS[heading];
+}
+
+int random_heading(){
+	return rand_range(0, TURN_NUM);
+}
+
+int turn_heading(int heading, int turn){
+	if(heading < 0) return heading;
+	return (heading + turn + TURN_NUM) % TURN_NUM;
+}
+
+int get_heading_turn(const Point& from, const Point& to){
+	Number amount = cross(from, to);
+	if(amount == 0) return 0;
+
+	Number sine = amount < 0 ? -amount : amount;
+	int steps = 1;
+	while(steps < TURN_NUM / 4 && sine > get_heading_direction(steps).y) steps++;
+	return amount < 0 ? -steps : steps;
+}
+
+int mirror_heading(int heading, bool mirror_x, bool mirror_y){
+	if(heading < 0) return heading;
+	if(mirror_x) heading = (TURN_NUM / 2 - heading + TURN_NUM) % TURN_NUM;
+	if(mirror_y) heading = (TURN_NUM - heading) % TURN_NUM;
+	return heading;
 }
 
 Point random_direction(){
@@ -106,35 +126,37 @@ Number cross(const Point& point1, const Point& point2){
 }
 
 bool polygon_collision(
-	const vector<Point>& polygon1,
-	const vector<Point>& polygon2,
+	Span<Point> polygon1,
+	Span<Point> polygon2,
 	Collision& collision
 ){
+	const size_t size1 = polygon1.size(), size2 = polygon2.size();
+
 	auto edge1 = polygon1[1] - polygon1[0];
 	normalize(edge1);
 	
-	int starting_index2 = polygon2.size();
+	int starting_index2 = size2;
 	while(cross(
 		edge1,
-		polygon2[(starting_index2 + 1) % polygon2.size()] - polygon2[starting_index2 % polygon2.size()]
+		polygon2[(starting_index2 + 1) % size2] - polygon2[starting_index2 % size2]
 	) > 0) starting_index2 ++;  // next polygon2 edge is going closer
 	while(cross(
 		edge1,
-		polygon2[(starting_index2 - 1) % polygon2.size()] - polygon2[starting_index2 % polygon2.size()]
+		polygon2[(starting_index2 - 1) % size2] - polygon2[starting_index2 % size2]
 	) > 0) starting_index2 --;  // previous polygon2 edge is going farther
 	
 	bool first = true;
-	auto edge2 = polygon2[(starting_index2 + 1) % polygon2.size()] - polygon2[starting_index2 % polygon2.size()];	
+	auto edge2 = polygon2[(starting_index2 + 1) % size2] - polygon2[starting_index2 % size2];	
 
 	normalize(edge2);
 	for(
 		int index1 = 0, index2 = starting_index2;
-		index1 < polygon1.size() || index2 < starting_index2 + polygon2.size();
+		index1 < size1 || index2 < starting_index2 + size2;
 	){
 		if(cross(edge1, edge2) > 0){
 			Number current_depth = cross(
 				edge2,
-				polygon1[index1 % polygon1.size()] - polygon2[index2 % polygon2.size()]
+				polygon1[index1 % size1] - polygon2[index2 % size2]
 			);
 			if(current_depth < 0) return false;
 			if(first || current_depth < collision.depth){
@@ -144,16 +166,16 @@ bool polygon_collision(
 					.x = -edge2.y,
 					.y = edge2.x
 				};
-				collision.position = polygon1[index1 % polygon1.size()];
+				collision.position = polygon1[index1 % size1];
 			}
 			index2 += 1;
 			
-			edge2 = polygon2[(index2 + 1) % polygon2.size()] - polygon2[index2 % polygon2.size()];
+			edge2 = polygon2[(index2 + 1) % size2] - polygon2[index2 % size2];
 			normalize(edge2);
 		} else {
 			Number current_depth = cross(
 				edge1,
-				polygon2[index2 % polygon1.size()] - polygon1[index1 % polygon1.size()]
+				polygon2[index2 % size1] - polygon1[index1 % size1]
 			);
 			if(current_depth < 0) return false;
 			if(first || current_depth < collision.depth){
@@ -163,11 +185,11 @@ bool polygon_collision(
 					.x = edge1.y,
 					.y = -edge1.x
 				};
-				collision.position = polygon2[index2 % polygon1.size()];
+				collision.position = polygon2[index2 % size1];
 			}
 			index1 += 1;
 			
-			edge1 = polygon1[(index1 + 1) % polygon1.size()] - polygon1[index1 % polygon1.size()];
+			edge1 = polygon1[(index1 + 1) % size1] - polygon1[index1 % size1];
 			normalize(edge1);
 		}
 	}
@@ -176,7 +198,7 @@ bool polygon_collision(
 }
 
 bool polygon_moving_circle_collision(
-	const vector<Point>& polygon,
+	Span<Point> polygon,
 	const Point& position,
 	const Point& velocity,
 	Number radius,
@@ -194,7 +216,7 @@ bool polygon_moving_circle_collision(
 		auto intersect = (radius - cross(position - polygon[i], edge));
 		
 		if(slope == 0){
-			if(intersect > 0) min_fraction = max_fraction + 1;
+			if(intersect < 0) min_fraction = max_fraction + 1;  // Moving along the edge, outside of it
 		}
 		else{
 			auto candidate = intersect / slope;
@@ -221,7 +243,7 @@ bool polygon_moving_circle_collision(
 		intersect = (distance - cross(position - polygon[(i + 1) % polygon.size()], edge));
 		
 		if(slope == 0){
-			if(intersect > 0) min_fraction = max_fraction + 1;
+			if(intersect < 0) min_fraction = max_fraction + 1;
 		}
 		else{
 			auto candidate = intersect / slope;
@@ -288,29 +310,35 @@ Point simple_collision_displacement(const Collision& collision1, const Collision
 	}) / cross(collision1.normal, collision2.normal);
 }
 
-bool get_collision_displacement(const vector<Collision>& collisions, Point& displacement){
+bool get_collision_displacement(Span<Collision> collisions, Point& displacement){
 	if(collisions.empty()) return false;
 
-	const Collision* main = nullptr;
-	set<const Collision*, function<bool(const Collision*, const Collision*)>> constraints([&](const Collision* collision1, const Collision* collision2){
-		return dot(main->normal, collision1->normal) > dot(main->normal, collision2->normal);
-	});
-	for(const auto& collision: collisions){
-		if(main == nullptr) main = &collision;
-		else constraints.insert(&collision);
+	// Remaining constraints ordered by decreasing alignment with the main one, equal ones dropped
+	const Collision* main = &collisions[0];
+	FixedVector<const Collision*, MAX_CONTACTS> constraints;
+	for(int i = 1; i < collisions.size(); i++){
+		Number alignment = dot(main->normal, collisions[i].normal);
+		int position = 0;
+		bool duplicate = false;
+		for(; position < constraints.size(); position++){
+			Number current = dot(main->normal, constraints[position]->normal);
+			if(current == alignment) duplicate = true;
+			if(current <= alignment) break;
+		}
+		if(!duplicate) constraints.insert(position, &collisions[i]);
 	}
 
-	deque<const Collision*> left_collisions, right_collisions;
-	deque<Point> left_points, right_points;
+	FixedDeque<const Collision*, MAX_CONTACTS> left_collisions, right_collisions;
+	FixedDeque<Point, MAX_CONTACTS> left_points, right_points;
 	bool using_main = true;
 	for(auto collision: constraints){
 		auto side = cross(main->normal, collision->normal);
 		if(side == 0) return false;
 
-		deque<const Collision*>& current = side > 0 ? right_collisions : left_collisions;
-		deque<const Collision*>& other = side > 0 ? left_collisions : right_collisions;
-		deque<Point>& current_points = side > 0 ? right_points : left_points;
-		deque<Point>& other_points = side > 0 ? left_points : right_points;
+		auto& current = side > 0 ? right_collisions : left_collisions;
+		auto& other = side > 0 ? left_collisions : right_collisions;
+		auto& current_points = side > 0 ? right_points : left_points;
+		auto& other_points = side > 0 ? left_points : right_points;
 		if(side > 0){
 			if(left_collisions.size() > 0 && cross(left_collisions.back()->normal, collision->normal) <= 0) return false;
 		}
@@ -373,10 +401,16 @@ bool get_collision_displacement(const vector<Collision>& collisions, Point& disp
 	return true;
 }
 
-bool collision_rotate(const vector<Collision>& collisions, const Point& center, Point& direction, Number threshold){
+bool collision_rotate(Span<Collision> collisions, const Point& center, Point& direction, Number threshold){
 	Point rotation = { .x = 1, .y = 0 };
 	for(const auto& collision: collisions){
-		auto candidate = -collision.depth / cross(collision.position - center, collision.normal);
+		auto depth = -collision.depth, arm = cross(collision.position - center, collision.normal);
+		if(arm == 0){
+			// Pushing through the center, no rotation resolves it
+			if(depth != 0) return false;
+			continue;
+		}
+		auto candidate = depth / arm;
 		if(candidate > 0){
 			if(rotation.y < 0 || candidate > threshold) return false;
 			if(rotation.y < candidate) rotation.y = candidate;
@@ -2,6 +2,8 @@
 #define _GAME_GEOMETRY_H
 
 #include "../../utils/numbers.h"
+#include "../../utils/span.h"
+#include "../../utils/fixed_vector.h"
 
 #include <vector>
 #include <iostream>
@@ -55,8 +57,14 @@ void normalize(Point& point);
 Number dot(const Point& point1, const Point& point2);
 Number cross(const Point& point1, const Point& point2);
 
-// random discrete direction
-Point random_discrete_direction();
+// Discrete headings, TURN_NUM of them with heading 0 along the x axis
+const Point& get_heading_direction(int heading);
+int random_heading();
+// Both keep -1 for directions that are off the discrete headings
+int turn_heading(int heading, int turn);
+int mirror_heading(int heading, bool mirror_x, bool mirror_y);
+// Whole heading steps that turn at least as far as from one direction to the other, up to a quarter turn
+int get_heading_turn(const Point& from, const Point& to);
 
 Point random_direction();
 
@@ -66,15 +74,20 @@ struct Collision{
 	Number depth;
 };
 
+// Tank contacts come from at most 8 maze polygons
+#define MAX_CONTACTS 8
+
+typedef FixedVector<Collision, MAX_CONTACTS> Contacts;
+
 /* Convex polygons only */
 bool polygon_collision(
-	const vector<Point>& polygon1,
-	const vector<Point>& polygon2,
+	Span<Point> polygon1,
+	Span<Point> polygon2,
 	Collision& collision
 );
 
 bool polygon_moving_circle_collision(
-	const vector<Point>& polygon,
+	Span<Point> polygon,
 	const Point& position,
 	const Point& velocity,
 	Number radius,
@@ -82,8 +95,8 @@ bool polygon_moving_circle_collision(
 	Number& fraction
 );
 
-bool get_collision_displacement(const vector<Collision>& collisions, Point& displacement);
+bool get_collision_displacement(Span<Collision> collisions, Point& displacement);
 
-bool collision_rotate(const vector<Collision>& collisions, const Point& center, Point& direction, Number threshold);
+bool collision_rotate(Span<Collision> collisions, const Point& center, Point& direction, Number threshold);
 
 #endif
\ No newline at end of file
@@ -3,11 +3,12 @@
 #include "geometry.h"
 
 #include <vector>
+#include <algorithm>
 #include <math.h>
 
 using namespace std;
 
-static inline vector<Point> get_maze_rect(int left, int right, int top, int bottom){
+static inline Quad get_maze_rect(int left, int right, int top, int bottom){
 	return {
 		{ .x = right + WALL_WIDTH, .y = top - WALL_WIDTH },
 		{ .x = right + WALL_WIDTH, .y = bottom + WALL_WIDTH },
@@ -16,8 +17,8 @@ static inline vector<Point> get_maze_rect(int left, int right, int top, int bott
 	};
 }
 
-vector<vector<Point>> get_maze_polygons(int x, int y, const Maze& maze){
-	vector<vector<Point>> polygons;
+MazePolygons get_maze_polygons(int x, int y, const Maze& maze){
+	MazePolygons polygons;
 
 	if(maze.has_hwall_below(x, y)){
 		polygons.push_back(get_maze_rect(
@@ -79,7 +80,7 @@ vector<vector<Point>> get_maze_polygons(int x, int y, const Maze& maze){
 	return polygons;
 }
 
-vector<Point> get_rotated_rectangle(
+Quad get_rotated_rectangle(
 	const Point& center,
 	const Point& direction, 
 	Number width, Number length
@@ -93,8 +94,8 @@ vector<Point> get_rotated_rectangle(
 	};
 }
 
-vector<Collision> get_tank_collisions(const TankState& tank, const Maze& maze){
-	vector<Collision> collisions;
+Contacts get_tank_collisions(const TankState& tank, const Maze& maze){
+	Contacts collisions;
 
 	const auto rect = get_rotated_rectangle(
 		tank.position,
@@ -123,13 +124,20 @@ void advance_tank(TankState& tank, const Maze& maze){
 
 	if(turn_state){
 		Point previous_direction = tank.direction;
+		int previous_heading = tank.heading;
 		Point previous_position = tank.position;
 		
-		tank.direction = rotate(
-			tank.direction,
-			{ .x = TURN_COS, .y = turn_state * TURN_SIN }
-		);
-		normalize(tank.direction);
+		if(tank.heading >= 0){
+			tank.heading = turn_heading(tank.heading, turn_state);
+			tank.direction = get_heading_direction(tank.heading);
+		}
+		else{
+			tank.direction = rotate(
+				tank.direction,
+				{ .x = TURN_COS, .y = turn_state * TURN_SIN }
+			);
+			normalize(tank.direction);
+		}
 
 		auto collisions = get_tank_collisions(tank, maze);
 		if(!collisions.empty()){
@@ -143,6 +151,7 @@ void advance_tank(TankState& tank, const Maze& maze){
 		}
 		if(!collisions.empty()){
 			tank.direction = previous_direction;
+			tank.heading = previous_heading;
 			tank.position = previous_position;
 		}
 	}
@@ -156,6 +165,7 @@ void advance_tank(TankState& tank, const Maze& maze){
 
 	if(speed != 0){
 		Point previous_direction = tank.direction;
+		int previous_heading = tank.heading;
 		Point previous_position = tank.position;
 		
 		tank.position += tank.direction * speed;
@@ -164,18 +174,74 @@ void advance_tank(TankState& tank, const Maze& maze){
 		if(!collisions.empty()){
 			for(auto& collision: collisions) collision.depth += EPSILON;
 
-			if(collision_rotate(collisions, tank.position, tank.direction, 2*TURN_SIN)){
-				normalize(tank.direction);
+			Point rotated = tank.direction;
+			if(collision_rotate(collisions, tank.position, rotated, 2*TURN_SIN)){
+				normalize(rotated);
+				// Sliding along a wall turns by whole heading steps, so the tank and its missiles stay on the table
+				if(tank.heading >= 0){
+					tank.heading = turn_heading(tank.heading, get_heading_turn(tank.direction, rotated));
+					tank.direction = get_heading_direction(tank.heading);
+				}
+				else tank.direction = rotated;
 				collisions = get_tank_collisions(tank, maze);
 			}
 		}
 		if(!collisions.empty()){
 			tank.direction = previous_direction;
+			tank.heading = previous_heading;
 			tank.position = previous_position;
 		}
 	}
 }
 
+Number get_moving_circle_wall_collision(
+	const Point& position, const Point& way, Number radius,
+	const Maze& maze, Point& normal
+){
+	double x = (double)position.x, y = (double)position.y;
+	double dx = (double)way.x, dy = (double)way.y;
+	
+	int cell_x = floor(x), cell_y = floor(y);
+	int step_x = dx > 0 ? 1 : -1, step_y = dy > 0 ? 1 : -1;
+	double delta_x = dx != 0 ? 1 / fabs(dx) : INFINITY;
+	double delta_y = dy != 0 ? 1 / fabs(dy) : INFINITY;
+	double next_x = dx > 0 ? (cell_x + 1 - x) / dx : dx < 0 ? (cell_x - x) / dx : INFINITY;
+	double next_y = dy > 0 ? (cell_y + 1 - y) / dy : dy < 0 ? (cell_y - y) / dy : INFINITY;
+	
+	Number fraction = 2;
+	for(double entered = 0; entered <= 1 && entered <= (double)fraction;){
+		for(const auto& polygon: get_maze_polygons(cell_x, cell_y, maze)){
+			Number current_fraction = 0;
+			Point current_normal = { .x = 0, .y = 0 };
+			
+			if(polygon_moving_circle_collision(
+				polygon,
+				position, way,
+				radius,
+				current_normal, current_fraction
+			)){
+				if(current_fraction < fraction && (current_normal.x * way.x < 0 || current_normal.y * way.y < 0)){
+					fraction = current_fraction;
+					normal = current_normal;
+				}
+			}
+		}
+		
+		if(next_x < next_y){
+			entered = next_x;
+			next_x += delta_x;
+			cell_x += step_x;
+		}
+		else{
+			entered = next_y;
+			next_y += delta_y;
+			cell_y += step_y;
+		}
+	}
+	
+	return fraction;
+}
+
 int advance_shot(
 	ShotDetails& shot,
 	const Maze& maze,
@@ -192,38 +258,17 @@ int advance_shot(
 
 	int tank_collision = -1;
 
-	bool finished = false;
-
-	while(!finished){
-		Point step = remaining_way;
-		auto len = length(step);
-		if(len < 0.5){
-			finished = true;
-		} else {
-			if( len > 1 ) normalize(step);
-			step /= 2;
-		}
-		
-		Number fraction = 1;
+	while(true){
 		Point normal = { .x = 0, .y = 0 };
-		for(const auto& polygon: get_maze_polygons(shot.position.x, shot.position.y, maze)){
-			Number current_fraction = 0;
-			Point current_normal = { .x = 0, .y = 0 };
-			
-			if(polygon_moving_circle_collision(
-				polygon,
-				shot.position, step,
-				shot.radius,
-				current_normal, current_fraction
-			)){
-				if(current_fraction < fraction && (current_normal.x * shot.velocity.x < 0 || current_normal.y * shot.velocity.y < 0)){
-					ignored_tank = -1;
-					finished = false;
-					fraction = current_fraction;
-					normal = current_normal;
-				}
-			}
-		}
+		Number fraction = get_moving_circle_wall_collision(
+			shot.position, remaining_way,
+			shot.radius,
+			maze, normal
+		);
+		
+		bool wall_collision = fraction < 1;
+		if(wall_collision) ignored_tank = -1;
+		else fraction = 1;
 		
 		for(int tank_index = 0; tank_index < tanks.size(); tank_index++){
 			if(!tanks[tank_index]->alive) continue;
@@ -239,36 +284,35 @@ int advance_shot(
 			
 			if(polygon_moving_circle_collision(
 				polygon,
-				shot.position, step,
+				shot.position, remaining_way,
 				shot.radius,
 				current_normal, current_fraction
 			)){
 				if(tank_index != ignored_tank && current_fraction < fraction){
-					finished = true;
 					tank_collision = tank_index;
 					fraction = current_fraction;
 				}
 			}
 		}
 		
-		step *= fraction;
+		Point step = remaining_way * fraction;
 		shot.position += step;
 		remaining_way -= step;
 		
-		if(tank_collision < 0 && fraction < 1){  // Wall collision
-			if(normal.x * shot.velocity.x < 0){
-				shot.velocity.x = -shot.velocity.x;
-				remaining_way.x = -remaining_way.x;
-			}
-			if(normal.y * shot.velocity.y < 0){
-				shot.velocity.y = -shot.velocity.y;
-				remaining_way.y = -remaining_way.y;
-			}
-			collisions.push_back({
-				.point = shot.position,
-				.time = length(remaining_way) / length(shot.velocity),
-			});
+		if(tank_collision >= 0 || !wall_collision) break;
+		
+		if(normal.x * shot.velocity.x < 0){
+			shot.velocity.x = -shot.velocity.x;
+			remaining_way.x = -remaining_way.x;
 		}
+		if(normal.y * shot.velocity.y < 0){
+			shot.velocity.y = -shot.velocity.y;
+			remaining_way.y = -remaining_way.y;
+		}
+		collisions.push_back({
+			.point = shot.position,
+			.time = length(remaining_way) / length(shot.velocity),
+		});
 	}
 
 	return tank_collision;
@@ -280,11 +324,17 @@ void advance_missile(
 	const Maze& maze
 ){
 	if(turn_direction){
-		missile.direction = rotate(
-			missile.direction,
-			{ .x = MISSILE_TURN_COS, .y = turn_direction * MISSILE_TURN_SIN }
-		);
-		normalize(missile.direction);
+		if(missile.heading >= 0){
+			missile.heading = turn_heading(missile.heading, turn_direction);
+			missile.direction = get_heading_direction(missile.heading);
+		}
+		else{
+			missile.direction = rotate(
+				missile.direction,
+				{ .x = MISSILE_TURN_COS, .y = turn_direction * MISSILE_TURN_SIN }
+			);
+			normalize(missile.direction);
+		}
 	}
 	
 	missile.position += missile.direction * MISSILE_SPEED;
@@ -302,8 +352,11 @@ void advance_missile(
 			.depth = 0
 		};
 		if(polygon_collision(rect, wall, collision)){
-			if(collision.normal.x * missile.direction.x > 0) missile.direction.x = -missile.direction.x;
-			if(collision.normal.y * missile.direction.y > 0) missile.direction.y = -missile.direction.y;
+			bool mirror_x = collision.normal.x * missile.direction.x > 0;
+			bool mirror_y = collision.normal.y * missile.direction.y > 0;
+			if(mirror_x) missile.direction.x = -missile.direction.x;
+			if(mirror_y) missile.direction.y = -missile.direction.y;
+			missile.heading = mirror_heading(missile.heading, mirror_x, mirror_y);
 		}
 	}
 }
@@ -333,13 +386,14 @@ bool check_missile_tank_collision(
 
 const Number TURN_THRESHOLD = Number(1)/20;
 
-int target_missile_turn(
+int get_missile_target(
 	const MazeMap& maze_map,
 	const MissileDetails& missile,
 	const vector<const TankState*>& tanks,
-	int& target
+	Point& waypoint,
+	int& distance
 ){
-	target = -1;
+	int target = -1;
 	Direction direction = {
 		.dx = 0, .dy = 0,
 		.distance = -1
@@ -364,19 +418,24 @@ int target_missile_turn(
 		}
 	}
 	
+	distance = direction.distance;
 	if(target == -1) {
-		return 0;
+		return -1;
 	}
 	
-	Point target_position = tanks[target]->position;
+	waypoint = tanks[target]->position;
 	if(direction.distance > 0){
-		target_position = { .x = 1, .y = 1 };
-		target_position /= 2;
-		target_position.x += (int)missile.position.x + direction.dx;
-		target_position.y += (int)missile.position.y + direction.dy;
+		waypoint = { .x = 1, .y = 1 };
+		waypoint /= 2;
+		waypoint.x += (int)missile.position.x + direction.dx;
+		waypoint.y += (int)missile.position.y + direction.dy;
 	}
 	
-	Point target_direction = target_position - missile.position;
+	return target;
+}
+
+int get_missile_turn(const MissileDetails& missile, const Point& waypoint){
+	Point target_direction = waypoint - missile.position;
 	normalize(target_direction);
 	Number turn_direction = cross(missile.direction, target_direction);	
 	
@@ -389,33 +448,83 @@ int target_missile_turn(
 	return 0;
 }
 
+// Slab test of the ray start + distance * t against a wall rectangle padded by WALL_WIDTH
+static inline void ray_wall_collision(
+	double x, double y, double dx, double dy,
+	double left, double right, double top, double bottom,
+	double& fraction
+){
+	double wall = (double)WALL_WIDTH;
+	left -= wall; right += wall;
+	top -= wall; bottom += wall;
+
+	double enter = 0, leave = fraction;
+	if(dx == 0){
+		if(x < left || x > right) return;
+	}
+	else{
+		double t1 = (left - x) / dx, t2 = (right - x) / dx;
+		enter = max(enter, min(t1, t2));
+		leave = min(leave, max(t1, t2));
+	}
+	if(dy == 0){
+		if(y < top || y > bottom) return;
+	}
+	else{
+		double t1 = (top - y) / dy, t2 = (bottom - y) / dy;
+		enter = max(enter, min(t1, t2));
+		leave = min(leave, max(t1, t2));
+	}
+	if(enter <= leave && enter < fraction) fraction = enter;
+}
+
 Number get_shrapnel_wall_collision(const ShrapnelDetails& shrapnel, const Maze& maze){
-	int sections = 1 + 2 * length(shrapnel.distance);
-	Point position = shrapnel.start;
-	Point step = shrapnel.distance / sections;
-	for(int i = 0; i < sections; i++, position += step){
-		bool collision = false;
-		Number fraction = 0;
-		for(const auto& polygon: get_maze_polygons(position.x, position.y, maze)){
-			Number current_fraction = 0;
-			Point current_normal = { .x = 0, .y = 0 };
-			
-			if(polygon_moving_circle_collision(
-				polygon,
-				position, step,
-				0,
-				current_normal, current_fraction
-			)){
-				if(!collision || current_fraction < fraction){
-					fraction = current_fraction;
-					collision = true;
-				}
+	double x = (double)shrapnel.start.x, y = (double)shrapnel.start.y;
+	double dx = (double)shrapnel.distance.x, dy = (double)shrapnel.distance.y;
+	
+	int cell_x = floor(x), cell_y = floor(y);
+	int step_x = dx > 0 ? 1 : -1, step_y = dy > 0 ? 1 : -1;
+	double delta_x = dx != 0 ? 1 / fabs(dx) : INFINITY;
+	double delta_y = dy != 0 ? 1 / fabs(dy) : INFINITY;
+	double next_x = dx > 0 ? (cell_x + 1 - x) / dx : dx < 0 ? (cell_x - x) / dx : INFINITY;
+	double next_y = dy > 0 ? (cell_y + 1 - y) / dy : dy < 0 ? (cell_y - y) / dy : INFINITY;
+	
+	double fraction = 2;
+	for(double entered = 0; entered <= 1 && entered <= fraction;){
+		// Every wall whose padded rectangle reaches into the cell
+		for(int wall_x = cell_x - 1; wall_x <= cell_x + 1; wall_x++){
+			for(int wall_y = cell_y - 1; wall_y <= cell_y; wall_y++){
+				if(maze.has_hwall_below(wall_x, wall_y)) ray_wall_collision(
+					x, y, dx, dy,
+					wall_x, wall_x + 1, wall_y + 1, wall_y + 1,
+					fraction
+				);
+			}
+		}
+		for(int wall_x = cell_x - 1; wall_x <= cell_x; wall_x++){
+			for(int wall_y = cell_y - 1; wall_y <= cell_y + 1; wall_y++){
+				if(maze.has_vwall_right(wall_x, wall_y)) ray_wall_collision(
+					x, y, dx, dy,
+					wall_x + 1, wall_x + 1, wall_y, wall_y + 1,
+					fraction
+				);
 			}
 		}
 		
-		if(collision) return (fraction + i) / sections;
+		if(next_x < next_y){
+			entered = next_x;
+			next_x += delta_x;
+			cell_x += step_x;
+		}
+		else{
+			entered = next_y;
+			next_y += delta_y;
+			cell_y += step_y;
+		}
 	}
-	return 2;
+	
+	if(fraction > 1) return 2;
+	return fraction;
 }
 Number get_shrapnel_tank_collision(const ShrapnelDetails& shrapnel, const TankState& tank){
 	if(!tank.alive) return 2;
@@ -458,7 +567,7 @@ bool check_upgrade_collision(const TankState& tank, const Upgrade& upgrade){
 	);
 }
 
-static inline vector<Point> get_mine_polygon(const Point& position, const Point& direction){
+static inline FixedVector<Point, 6> get_mine_polygon(const Point& position, const Point& direction){
 	static const Point mine_vertices[2] = {
 		{ .x = (MINE_SIZE * 4) / 5, .y = -MINE_SIZE / 5 },
 		{ .x = (MINE_SIZE * 4) / 5, .y = MINE_SIZE / 5 },
@@ -469,7 +578,7 @@ static inline vector<Point> get_mine_polygon(const Point& position, const Point&
 		{ .x = -Number(1) / 2, .y = -sqrt(3)/2 },
 	};
 
-	vector<Point> polygon;
+	FixedVector<Point, 6> polygon;
 	for(const Point& rotation: mine_rotations){
 		Point total_rotation = rotate(rotation, direction);
 		for(const Point& vertex: mine_vertices){
@@ -493,16 +602,51 @@ bool check_mine_collision(const MineDetails& mine, const TankState& tank){
 	);
 }
 
-bool check_death_ray_collision(const vector<Point>& path, const TankState& tank){
+static inline void extend_bounds(Point& low, Point& high, Point point){
+	if(point.x < low.x) low.x = point.x;
+	if(point.y < low.y) low.y = point.y;
+	if(point.x > high.x) high.x = point.x;
+	if(point.y > high.y) high.y = point.y;
+}
+
+vector<DeathRaySegment> compile_death_ray(const vector<Point>& path){
+	// The moving circle test keeps polygon corners square, reaching out up to sqrt(2) times the width
+	const Point padding = { .x = DEATH_RAY_WIDTH * 3 / 2, .y = DEATH_RAY_WIDTH * 3 / 2 };
+
+	vector<DeathRaySegment> segments;
+	segments.reserve(path.size());
+	for(int i = 1; i < path.size(); i++){
+		Point low = path[i-1], high = path[i-1];
+		extend_bounds(low, high, path[i]);
+		segments.push_back({
+			.start = path[i-1],
+			.way = path[i] - path[i-1],
+			.low = low - padding,
+			.high = high + padding
+		});
+	}
+	return segments;
+}
+
+bool check_death_ray_collision(const vector<DeathRaySegment>& segments, const TankState& tank){
+	const auto polygon = get_rotated_rectangle(
+		tank.position, tank.direction,
+		TANK_WIDTH, TANK_LENGTH
+	);
+	Point low = polygon[0], high = polygon[0];
+	for(const auto& vertex: polygon) extend_bounds(low, high, vertex);
+
 	Point normal = { .x = 0, .y = 0 };
 	Number fraction = 0;
-	for(int i = 1; i < path.size(); i++){
+	for(const auto& segment: segments){
+		if(
+			low.x > segment.high.x || high.x < segment.low.x ||
+			low.y > segment.high.y || high.y < segment.low.y
+		) continue;
+
 		if(polygon_moving_circle_collision(
-			get_rotated_rectangle(
-				tank.position, tank.direction,
-				TANK_WIDTH, TANK_LENGTH
-			),
-			path[i-1], path[i] - path[i-1],
+			polygon,
+			segment.start, segment.way,
 			DEATH_RAY_WIDTH,
 			normal, fraction
 		)) return true;
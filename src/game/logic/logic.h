@@ -2,11 +2,33 @@
 #define _GAME_LOGIC_H
 
 #include "maze.h"
+#include "geometry.h"
 
 #include "../data/game_objects.h"
+#include "../../utils/fixed_vector.h"
 
+typedef FixedVector<Point, 4> Quad;
+typedef FixedVector<Quad, 8> MazePolygons;
+
+// Walls around the cell, padded by WALL_WIDTH
+MazePolygons get_maze_polygons(int x, int y, const Maze& maze);
+Quad get_rotated_rectangle(
+	const Point& center,
+	const Point& direction, 
+	Number width, Number length
+);
+
+// Contacts of the tank with the walls around its cell
+Contacts get_tank_collisions(const TankState& tank, const Maze& maze);
 void advance_tank(TankState& tank, const Maze& maze);
 
+// Walks the cells crossed by position + way * [0, 1] and returns the earliest
+// hit against a wall the circle is approaching, or 2 if there is none
+Number get_moving_circle_wall_collision(
+	const Point& position, const Point& way, Number radius,
+	const Maze& maze, Point& normal
+);
+
 int advance_shot(
 	ShotDetails& shot,
 	const Maze& maze,
@@ -24,12 +46,14 @@ bool check_missile_tank_collision(
 	const MissileDetails& missile,
 	const TankState& tank
 );
-int target_missile_turn(
+int get_missile_target(
 	const MazeMap& maze_map,
 	const MissileDetails& missile,
 	const vector<const TankState*>& tanks,
-	int& target
+	Point& waypoint,
+	int& distance
 );
+int get_missile_turn(const MissileDetails& missile, const Point& waypoint);
 
 Number get_shrapnel_wall_collision(const ShrapnelDetails& shrapnel, const Maze& maze);
 Number get_shrapnel_tank_collision(const ShrapnelDetails& shrapnel, const TankState& tank);
@@ -38,6 +62,12 @@ Number get_shrapnel_way(int time);
 bool check_upgrade_collision(const TankState& tank, const Upgrade& upgrade);
 bool check_mine_collision(const MineDetails& mine, const TankState& tank);
 
-bool check_death_ray_collision(const vector<Point>& path, const TankState& tank);
+struct DeathRaySegment{
+	Point start, way;
+	Point low, high;  // Bounding box padded by DEATH_RAY_WIDTH
+};
+
+vector<DeathRaySegment> compile_death_ray(const vector<Point>& path);
+bool check_death_ray_collision(const vector<DeathRaySegment>& segments, const TankState& tank);
 
 #endif
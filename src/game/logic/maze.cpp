@@ -2,7 +2,6 @@
 
 #include "../../utils/utils.h"
 
-#include<deque>
 #include<utility>
 
 Maze empty_maze(int w, int h){
@@ -67,55 +66,53 @@ const Direction NO_WAY = {
 	.distance = -1
 };
 
-void bfs(const Maze& maze, int end_x, int end_y, vector<vector<Direction>>& results){
-	deque<pair<int, int>> queue;
+static void bfs(
+	const Maze& maze, int end_x, int end_y,
+	Direction* results, vector<pair<int, int>>& queue
+){
+	const int h = maze.get_h();
+	queue.clear();
 	queue.push_back({end_x, end_y});
-	results[end_x][end_y].distance = 0;
+	results[end_x * h + end_y].distance = 0;
 	
-	while(!queue.empty()){
-		auto [x, y] = queue.front();
-		queue.pop_front();
+	for(int next = 0; next < queue.size(); next++){
+		auto [x, y] = queue[next];
+		int distance = results[x * h + y].distance + 1;
 		
-		if(!maze.has_hwall_below(x, y) && results[x][y + 1].distance == -1){
-			results[x][y + 1].dy = -1;
-			results[x][y + 1].distance = results[x][y].distance + 1;
+		if(!maze.has_hwall_below(x, y) && results[x * h + y + 1].distance == -1){
+			results[x * h + y + 1].dy = -1;
+			results[x * h + y + 1].distance = distance;
 			queue.push_back({x, y + 1});
 		}
-		if(!maze.has_hwall_below(x, y - 1) && results[x][y - 1].distance == -1){
-			results[x][y - 1].dy = 1;
-			results[x][y - 1].distance = results[x][y].distance + 1;
+		if(!maze.has_hwall_below(x, y - 1) && results[x * h + y - 1].distance == -1){
+			results[x * h + y - 1].dy = 1;
+			results[x * h + y - 1].distance = distance;
 			queue.push_back({x, y - 1});
 		}
-		if(!maze.has_vwall_right(x, y) && results[x + 1][y].distance == -1){
-			results[x + 1][y].dx = -1;
-			results[x + 1][y].distance = results[x][y].distance + 1;
+		if(!maze.has_vwall_right(x, y) && results[(x + 1) * h + y].distance == -1){
+			results[(x + 1) * h + y].dx = -1;
+			results[(x + 1) * h + y].distance = distance;
 			queue.push_back({x + 1, y});
 		}
-		if(!maze.has_vwall_right(x - 1, y) && results[x - 1][y].distance == -1){
-			results[x - 1][y].dx  = 1;
-			results[x - 1][y].distance = results[x][y].distance + 1;
+		if(!maze.has_vwall_right(x - 1, y) && results[(x - 1) * h + y].distance == -1){
+			results[(x - 1) * h + y].dx  = 1;
+			results[(x - 1) * h + y].distance = distance;
 			queue.push_back({x - 1, y});
 		}
 	}
 };
 
-MazeMap::MazeMap(const Maze& maze) : directions(
-		maze.get_w(),
-		vector<vector<vector<Direction>>>(
-			maze.get_h(),
-			vector<vector<Direction>>(
-				maze.get_w(),
-				vector<Direction>(
-					maze.get_h(),
-					NO_WAY
-				)
-			)
-		)
-	) {
+MazeMap::MazeMap(const Maze& maze) :
+	w(maze.get_w()),
+	h(maze.get_h()),
+	directions(w * h * w * h, NO_WAY) {
 
-	for(int end_x = 0; end_x < maze.get_w(); end_x++){
-		for(int end_y = 0; end_y < maze.get_h(); end_y++){
-			bfs(maze, end_x, end_y, directions[end_x][end_y]);
+	// Every cell is queued once per search, so one queue serves all of them
+	vector<pair<int, int>> queue;
+	queue.reserve(w * h);
+	for(int end_x = 0; end_x < w; end_x++){
+		for(int end_y = 0; end_y < h; end_y++){
+			bfs(maze, end_x, end_y, &directions[(end_x * h + end_y) * w * h], queue);
 		};
 	}
 }
@@ -124,17 +121,7 @@ const Direction& MazeMap::get_direction(
 	int start_x, int start_y,
 	int end_x, int end_y
 ) const{
-	if(end_x >= 0 && end_x < directions.size()){
-		const auto& end_row = directions[end_x];
-		if(end_y >= 0 && end_y < end_row.size()){
-			const auto& end = end_row[end_y];
-			if(start_x >= 0 && start_x < end.size()){
-				const auto& row = end[start_x];
-				if(start_y >= 0 && start_y < row.size()){
-					return row[start_y];
-				}
-			}
-		}
-	}
-	return NO_WAY;
+	if(end_x < 0 || end_x >= w || end_y < 0 || end_y >= h) return NO_WAY;
+	if(start_x < 0 || start_x >= w || start_y < 0 || start_y >= h) return NO_WAY;
+	return directions[(end_x * h + end_y) * w * h + start_x * h + start_y];
 }
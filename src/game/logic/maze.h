@@ -10,8 +10,10 @@ struct Direction{
 	int distance;
 };
 
+// Shortest routes between every two cells, searched when the round starts
 class MazeMap{
-	vector<vector<vector<vector<Direction>>>> directions;
+	const int w, h;
+	vector<Direction> directions;  // Every start cell per end cell, in one block
 public:
 	MazeMap(const Maze& maze);
 	
@@ -0,0 +1,93 @@
+#include "tick_profile.h"
+
+#ifdef TICK_PROFILING
+
+#include <cstring>
+#include <iomanip>
+
+static const char* PHASE_NAMES[(int)TickPhase::COUNT] = {
+	"tanks",
+	"shots",
+	"missiles",
+	"mines",
+	"death_rays",
+	"shrapnel",
+	"upgrades",
+	"state_hash",
+};
+
+TickProfile::TickProfile(){
+	reset();
+}
+
+void TickProfile::record(TickPhase phase, uint64_t ns, int entity_count){
+	auto& current = stats[(int)phase];
+	current.calls++;
+	current.total_ns += ns;
+	if(ns > current.max_ns) current.max_ns = ns;
+	current.total_entities += entity_count;
+	if(entity_count > current.max_entities) current.max_entities = entity_count;
+
+	int bucket = 0;
+	while(bucket + 1 < TICK_PROFILE_BUCKETS && (ns >> (bucket + 1))) bucket++;
+	current.histogram[bucket]++;
+}
+
+void TickProfile::merge(const TickProfile& other){
+	for(int phase = 0; phase < (int)TickPhase::COUNT; phase++){
+		auto& current = stats[phase];
+		const auto& added = other.stats[phase];
+		current.calls += added.calls;
+		current.total_ns += added.total_ns;
+		if(added.max_ns > current.max_ns) current.max_ns = added.max_ns;
+		current.total_entities += added.total_entities;
+		if(added.max_entities > current.max_entities) current.max_entities = added.max_entities;
+		for(int bucket = 0; bucket < TICK_PROFILE_BUCKETS; bucket++){
+			current.histogram[bucket] += added.histogram[bucket];
+		}
+	}
+}
+
+const TickPhaseStats& TickProfile::get_stats(TickPhase phase) const{
+	return stats[(int)phase];
+}
+
+uint64_t TickProfile::get_quantile_ns(TickPhase phase, double quantile) const{
+	const auto& current = stats[(int)phase];
+	uint64_t needed = current.calls * quantile, seen = 0;
+	for(int bucket = 0; bucket < TICK_PROFILE_BUCKETS; bucket++){
+		seen += current.histogram[bucket];
+		if(seen > needed) return (uint64_t)2 << bucket;
+	}
+	return current.max_ns;
+}
+
+void TickProfile::reset(){
+	memset(stats, 0, sizeof(stats));
+}
+
+void TickProfile::dump(ostream& output) const{
+	output << left << setw(12) << "phase" << right
+		<< setw(10) << "calls"
+		<< setw(12) << "mean_ns"
+		<< setw(12) << "p50_ns"
+		<< setw(12) << "p99_ns"
+		<< setw(12) << "max_ns"
+		<< setw(14) << "mean_entities"
+		<< setw(14) << "max_entities" << endl;
+
+	for(int phase = 0; phase < (int)TickPhase::COUNT; phase++){
+		const auto& current = stats[phase];
+		uint64_t calls = current.calls ? current.calls : 1;
+		output << left << setw(12) << PHASE_NAMES[phase] << right
+			<< setw(10) << current.calls
+			<< setw(12) << current.total_ns / calls
+			<< setw(12) << get_quantile_ns((TickPhase)phase, 0.5)
+			<< setw(12) << get_quantile_ns((TickPhase)phase, 0.99)
+			<< setw(12) << current.max_ns
+			<< setw(14) << fixed << setprecision(1) << (double)current.total_entities / calls
+			<< setw(14) << current.max_entities << endl;
+	}
+}
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef _TICK_PROFILE_H
+#define _TICK_PROFILE_H
+
+// Per phase instrumentation of the simulation tick: timing statistics with -DTICK_PROFILING,
+// timeline events with -DTRACING, nothing otherwise
+
+#include "../../utils/trace.h"
+
+#ifdef TICK_PROFILING
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+using namespace std;
+
+enum class TickPhase : unsigned char{
+	TANKS = 0,
+	SHOTS,
+	MISSILES,
+	MINES,
+	DEATH_RAYS,
+	SHRAPNEL,
+	UPGRADES,
+	STATE_HASH,
+	COUNT
+};
+
+#define TICK_PROFILE_BUCKETS 32
+
+struct TickPhaseStats{
+	uint64_t calls;
+	uint64_t total_ns, max_ns;
+	uint64_t total_entities, max_entities;
+	uint64_t histogram[TICK_PROFILE_BUCKETS];  // Bucket i counts durations in [2^i, 2^(i+1)) ns
+};
+
+class TickProfile{
+	TickPhaseStats stats[(int)TickPhase::COUNT];
+	chrono::steady_clock::time_point started[(int)TickPhase::COUNT];
+	int entities[(int)TickPhase::COUNT];
+public:
+	TickProfile();
+
+	void begin(TickPhase phase, int entity_count){
+		entities[(int)phase] = entity_count;
+		started[(int)phase] = chrono::steady_clock::now();
+	}
+	void end(TickPhase phase){
+		record(phase, chrono::duration_cast<chrono::nanoseconds>(
+			chrono::steady_clock::now() - started[(int)phase]
+		).count(), entities[(int)phase]);
+	}
+	void record(TickPhase phase, uint64_t ns, int entity_count);
+	// Adds the statistics of another profile, e.g. of another game
+	void merge(const TickProfile& other);
+
+	const TickPhaseStats& get_stats(TickPhase phase) const;
+	// Upper bound of the bucket holding the given quantile
+	uint64_t get_quantile_ns(TickPhase phase, double quantile) const;
+
+	void reset();
+	void dump(ostream& output) const;
+};
+
+#define TICK_PROFILE_RECORD_BEGIN(profile, phase, entity_count) (profile).begin(TickPhase::phase, entity_count)
+#define TICK_PROFILE_RECORD_END(profile, phase) (profile).end(TickPhase::phase)
+
+#else
+
+#define TICK_PROFILE_RECORD_BEGIN(profile, phase, entity_count)
+#define TICK_PROFILE_RECORD_END(profile, phase)
+
+#endif
+
+#define TICK_PROFILE_BEGIN(profile, phase, entity_count) \
+	TICK_PROFILE_RECORD_BEGIN(profile, phase, entity_count); TRACE_BEGIN("tick " #phase)
+#define TICK_PROFILE_END(profile, phase) \
+	TRACE_END("tick " #phase); TICK_PROFILE_RECORD_END(profile, phase)
+
+#endif
@@ -0,0 +1,247 @@
+#include "replay.h"
+
+#include "../../utils/serialization.h"
+
+#include <sstream>
+#include <algorithm>
+
+const unsigned int REPLAY_MAGIC = 0x50525454;  // "TTRP"
+const unsigned int REPLAY_INDEX_MAGIC = 0x49525454;  // "TTRI"
+const int REPLAY_VERSION = 7;
+
+const size_t REPLAY_FOOTER_SIZE = 8 + 4 + 4;
+
+enum class ReplayRecord : unsigned char{
+	KEYFRAME = 0,
+	TICK = 1
+};
+
+void ReplayKeyframe::serialize(ostream& output) const{
+	serialize_value(output, tick);
+	serialize_value(output, offset);
+}
+ReplayKeyframe ReplayKeyframe::deserialize(istream& input){
+	auto tick = deserialize_value<int>(input);
+	auto offset = deserialize_value<unsigned long long>(input);
+	return {
+		.tick = tick,
+		.offset = offset
+	};
+}
+
+ReplayWriter::ReplayWriter(const char* filename, Game& game, int keyframe_interval) :
+	game(game),
+	keyframe_interval(keyframe_interval),
+	tick(0) {
+
+	file.open(filename, ios::out | ios::binary);
+	if(!file.is_open()) return;
+
+	serialize_value(file, REPLAY_MAGIC);
+	serialize_value(file, REPLAY_VERSION);
+
+	serialize_value(file, (unsigned char)game.get_maze_generation());
+	vector<unsigned char> allowed_upgrades;
+	for(auto type: game.get_allowed_upgrades()) allowed_upgrades.push_back((unsigned char)type);
+	serialize_value(file, allowed_upgrades);
+	serialize_value(file, (int)game.get_states().size());
+	serialize_value(file, keyframe_interval);
+
+	write_keyframe();
+
+	game.add_observer(this);
+}
+
+ReplayWriter::~ReplayWriter(){
+	close();
+}
+
+bool ReplayWriter::is_open() const{
+	return file.is_open();
+}
+
+void ReplayWriter::write_keyframe(){
+	keyframes.push_back({
+		.tick = tick,
+		.offset = (unsigned long long)file.tellp()
+	});
+
+	stringstream snapshot;
+	game.serialize(snapshot);
+	string data = snapshot.str();
+
+	serialize_value(file, (unsigned char)ReplayRecord::KEYFRAME);
+	serialize_value(file, tick);
+	serialize_value(file, (unsigned int)data.size());
+	file.write(data.data(), data.size());
+}
+
+void ReplayWriter::on_step(){
+	serialize_value(file, (unsigned char)ReplayRecord::TICK);
+	for(const auto& tank: game.get_states()){
+		const KeyState& keys = tank.state.key_state;
+		serialize_flags(file, keys.left, keys.right, keys.forward, keys.back, keys.shoot, tank.state.active);
+	}
+	serialize_value(file, (unsigned int)game.get_state_hash());
+	tick++;
+
+	if(tick % keyframe_interval == 0) write_keyframe();
+}
+
+void ReplayWriter::close(){
+	if(!file.is_open()) return;
+	game.remove_observer(this);
+
+	unsigned long long index_offset = file.tellp();
+	serialize_value(file, keyframes);
+
+	serialize_value(file, index_offset);
+	serialize_value(file, tick);
+	serialize_value(file, REPLAY_INDEX_MAGIC);
+
+	file.close();
+}
+
+ReplayPlayer::ReplayPlayer(const char* filename) :
+	file(filename),
+	valid(false),
+	tank_num(0),
+	tick_count(0),
+	game(nullptr),
+	tick(0),
+	position(0),
+	desync_tick(-1) {
+
+	if(!file.is_open()) return;
+
+	MemoryBuffer buffer(file.get_data(), file.get_data() + file.get_size());
+	istream input(&buffer);
+
+	if(deserialize_value<unsigned int>(input) != REPLAY_MAGIC) return;
+	if(deserialize_value<int>(input) != REPLAY_VERSION) return;
+
+	auto maze_generation = (MazeGeneration)deserialize_value<unsigned char>(input);
+	set<Upgrade::Type> allowed_upgrades;
+	for(auto type: deserialize_value<vector<unsigned char>>(input)) allowed_upgrades.insert((Upgrade::Type)type);
+	tank_num = deserialize_value<int>(input);
+	deserialize_value<int>(input);  // keyframe interval, only needed when writing
+
+	if(!input || !read_index() || keyframes.empty()) return;
+
+	game = make_unique<Game>(maze_generation, allowed_upgrades, tank_num);
+	if(!load_keyframe(keyframes.front())) return;
+
+	valid = true;
+}
+
+bool ReplayPlayer::read_index(){
+	if(file.get_size() < REPLAY_FOOTER_SIZE) return false;
+
+	const char* footer = file.get_data() + file.get_size() - REPLAY_FOOTER_SIZE;
+	MemoryBuffer footer_buffer(footer, footer + REPLAY_FOOTER_SIZE);
+	istream footer_input(&footer_buffer);
+
+	auto index_offset = deserialize_value<unsigned long long>(footer_input);
+	tick_count = deserialize_value<int>(footer_input);
+	if(deserialize_value<unsigned int>(footer_input) != REPLAY_INDEX_MAGIC) return false;
+	if(index_offset >= file.get_size() - REPLAY_FOOTER_SIZE) return false;
+
+	MemoryBuffer index_buffer(file.get_data() + index_offset, footer);
+	istream index_input(&index_buffer);
+	keyframes = deserialize_value<vector<ReplayKeyframe>>(index_input);
+	if(!index_input) return false;
+
+	// Keyframes are written before the index
+	for(const auto& keyframe: keyframes){
+		if(keyframe.offset >= index_offset) return false;
+	}
+	return true;
+}
+
+bool ReplayPlayer::load_keyframe(const ReplayKeyframe& keyframe){
+	const char* end = file.get_data() + file.get_size();
+	MemoryBuffer buffer(file.get_data() + keyframe.offset, end);
+	istream input(&buffer);
+
+	deserialize_value<unsigned char>(input);
+	auto keyframe_tick = deserialize_value<int>(input);
+	auto length = deserialize_value<unsigned int>(input);
+	if(!input) return false;
+
+	// Fails before touching the game when the snapshot runs past the end of the file
+	size_t start = keyframe.offset + 1 + 4 + 4;
+	if(start + length > file.get_size()) return false;
+	MemoryBuffer snapshot_buffer(file.get_data() + start, file.get_data() + start + length);
+	istream snapshot(&snapshot_buffer);
+	game->load(snapshot);
+
+	tick = keyframe_tick;
+	position = start + length;
+	return true;
+}
+
+bool ReplayPlayer::is_open() const{
+	return valid;
+}
+
+int ReplayPlayer::get_tick_count() const{
+	return tick_count;
+}
+int ReplayPlayer::get_tick() const{
+	return tick;
+}
+GameView& ReplayPlayer::get_view() const{
+	return *game;
+}
+uint64_t ReplayPlayer::get_state_hash() const{
+	return game->get_state_hash();
+}
+int ReplayPlayer::get_desync_tick() const{
+	return desync_tick;
+}
+
+void ReplayPlayer::seek(int target){
+	if(!valid) return;
+	if(target < 0) target = 0;
+	if(target > tick_count) target = tick_count;
+
+	auto keyframe = upper_bound(
+		keyframes.begin(), keyframes.end(), target,
+		[](int tick, const ReplayKeyframe& keyframe){ return tick < keyframe.tick; }
+	);
+	if(keyframe != keyframes.begin()) keyframe--;
+
+	if((target < tick || keyframe->tick > tick) && !load_keyframe(*keyframe)) return;
+	while(tick < target && step());
+}
+
+bool ReplayPlayer::step(){
+	if(!valid || tick >= tick_count) return false;
+
+	const char* end = file.get_data() + file.get_size();
+	MemoryBuffer buffer(file.get_data() + position, end);
+	istream input(&buffer);
+
+	auto record = (ReplayRecord)deserialize_value<unsigned char>(input);
+	while(record == ReplayRecord::KEYFRAME){
+		deserialize_value<int>(input);
+		auto length = deserialize_value<unsigned int>(input);
+		input.ignore(length);
+		record = (ReplayRecord)deserialize_value<unsigned char>(input);
+	}
+	if(!input || record != ReplayRecord::TICK) return false;
+
+	for(int i = 0; i < tank_num; i++){
+		auto [left, right, forward, back, shoot, active] = deserialize_flags<6>(input);
+		PlayerInterface& player = game->get_player_interface(i);
+		player.set_active(active);
+		if(active) player.step(game->get_round(), KeyState(left, right, forward, back, shoot));
+	}
+	auto state_hash = deserialize_value<unsigned int>(input);
+	position += buffer.get_position();
+
+	game->advance();
+	tick++;
+	if(desync_tick < 0 && state_hash != (unsigned int)game->get_state_hash()) desync_tick = tick;
+	return true;
+}
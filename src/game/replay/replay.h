@@ -0,0 +1,91 @@
+#ifndef _REPLAY_H
+#define _REPLAY_H
+
+#include "../logic/game.h"
+#include "../interface/game_observer.h"
+#include "../interface/game_view.h"
+
+#include "../../utils/mapped_file.h"
+
+#include <fstream>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+/*
+Replay file layout:
+	header: magic, version, game configuration, keyframe interval
+	records: keyframe (tick, snapshot length, Game snapshot) or tick (key flags per tank, low half of the state hash)
+	seek index: keyframe ticks and their record offsets
+	footer: index offset, tick count, magic
+*/
+
+#define REPLAY_KEYFRAME_INTERVAL 600
+
+struct ReplayKeyframe{
+	int tick;
+	unsigned long long offset;
+
+	void serialize(ostream& output) const;
+	static ReplayKeyframe deserialize(istream& input);
+};
+
+class ReplayWriter : public GameObserver{
+	Game& game;
+	ofstream file;
+	const int keyframe_interval;
+
+	int tick;
+	vector<ReplayKeyframe> keyframes;
+
+	void write_keyframe();
+public:
+	ReplayWriter(const char* filename, Game& game, int keyframe_interval = REPLAY_KEYFRAME_INTERVAL);
+
+	ReplayWriter(const ReplayWriter&) = delete;
+	ReplayWriter(ReplayWriter&&) = delete;
+	ReplayWriter& operator=(const ReplayWriter&) = delete;
+	ReplayWriter& operator=(ReplayWriter&&) = delete;
+
+	~ReplayWriter();
+
+	bool is_open() const;
+	void close();
+
+	void on_step();
+};
+
+class ReplayPlayer{
+	MappedFile file;
+	bool valid;
+
+	int tank_num;
+	int tick_count;
+	vector<ReplayKeyframe> keyframes;
+
+	unique_ptr<Game> game;
+	int tick;
+	size_t position;
+	int desync_tick;
+
+	bool read_index();
+	bool load_keyframe(const ReplayKeyframe& keyframe);
+public:
+	ReplayPlayer(const char* filename);
+
+	bool is_open() const;
+
+	int get_tick_count() const;
+	int get_tick() const;
+	GameView& get_view() const;
+	uint64_t get_state_hash() const;  // Of the game at the current tick
+	// First tick replayed to a different state than was recorded, -1 while none was
+	int get_desync_tick() const;
+
+	// Jumps to the given tick through the closest preceding keyframe
+	void seek(int tick);
+	bool step();
+};
+
+#endif
@@ -8,7 +8,7 @@
 class Controller{
 public:
 	virtual void handle_event(const SDL_Event& event) = 0;
-	virtual KeyState get_state() = 0;
+	virtual KeyState get_state() = 0;  // Called from the simulation thread
 };
 
 #endif
@@ -32,28 +32,44 @@ KeySet KeySet::deserialize(istream& input){
 	return value;
 }
 
-KeyController::KeyController(const KeySet& key_set) : key_set(key_set) {}
+#define KEY_LEFT 1
+#define KEY_RIGHT 2
+#define KEY_FORWARD 4
+#define KEY_BACK 8
+#define KEY_SHOOT 16
+
+KeyController::KeyController(const KeySet& key_set) : held(0), pressed(0), key_set(key_set) {}
+
+unsigned char KeyController::get_key_bit(SDL_Scancode scancode) const{
+	unsigned char bit = 0;
+	if(scancode == key_set.left) bit |= KEY_LEFT;
+	if(scancode == key_set.right) bit |= KEY_RIGHT;
+	if(scancode == key_set.forward) bit |= KEY_FORWARD;
+	if(scancode == key_set.back) bit |= KEY_BACK;
+	if(scancode == key_set.shoot) bit |= KEY_SHOOT;
+	return bit;
+}
 
 void KeyController::handle_event(const SDL_Event& event){
 	if(event.type == SDL_KEYDOWN){
-		if(event.key.keysym.scancode == key_set.left) state.left = true;
-		if(event.key.keysym.scancode == key_set.right) state.right = true;
-		if(event.key.keysym.scancode == key_set.forward) state.forward = true;
-		if(event.key.keysym.scancode == key_set.back) state.back = true;
-		if(event.key.keysym.scancode == key_set.shoot) state.shoot = true;
+		auto bit = get_key_bit(event.key.keysym.scancode);
+		held.fetch_or(bit, memory_order_relaxed);
+		pressed.fetch_or(bit, memory_order_relaxed);  // Latched so short presses between ticks are not lost
+	}
+	if(event.type == SDL_KEYUP){
+		held.fetch_and(~get_key_bit(event.key.keysym.scancode), memory_order_relaxed);
 	}
 }
 KeyState KeyController::get_state(){
-	KeyState result = state;
-	
-	auto keyboard_state = SDL_GetKeyboardState(NULL);
-	state.left = keyboard_state[key_set.left];
-	state.right = keyboard_state[key_set.right];
-	state.forward = keyboard_state[key_set.forward];
-	state.back = keyboard_state[key_set.back];
-	state.shoot = keyboard_state[key_set.shoot];
-	
-	return result;
+	unsigned char keys = held.load(memory_order_relaxed) | pressed.exchange(0, memory_order_relaxed);
+
+	return KeyState(
+		keys & KEY_LEFT,
+		keys & KEY_RIGHT,
+		keys & KEY_FORWARD,
+		keys & KEY_BACK,
+		keys & KEY_SHOOT
+	);
 }
 
 KeySetManager::KeySetManager(const char* filename) :
@@ -7,6 +7,7 @@
 
 #include <vector>
 #include <iostream>
+#include <atomic>
 
 using namespace std;
 
@@ -18,8 +19,11 @@ struct KeySet{
 };
 
 class KeyController : public Controller{
-	KeyState state;
+	// Key bitmasks, written by the event thread and read by the simulation thread
+	atomic<unsigned char> held, pressed;
 	KeySet key_set;
+
+	unsigned char get_key_bit(SDL_Scancode scancode) const;
 public:
 	KeyController(const KeySet& key_set);
 	
@@ -6,6 +6,8 @@
 
 #include "../../game/logic/logic.h"
 
+#include "../../utils/trace.h"
+
 #define DRAW_SCALE 100
 
 #define _USE_MATH_DEFINES
@@ -17,104 +19,197 @@ static inline double angle(const Point& point){
 	return RAD2DEG(atan2((double)point.x, (double)-point.y));
 }
 
-BoardDrawer::BoardDrawer(GameView* view, const GameSettings& settings) :
+BoardDrawer::BoardDrawer(const GameView* view, const GameSettings& settings) :
 	view(view),
 	settings(settings),
-	circle_texture(nullptr),
-	texture(nullptr) {
+	texture(nullptr),
+	wall_round(-1),
+	wall_texture(nullptr),
+	atlas(nullptr) {
 
 }
 
 constexpr int CIRCLE_RADIUS = 50;
 constexpr unsigned int CIRCLE_POINTS = 100;
 
-void BoardDrawer::draw(SDL_Renderer* renderer){
+// Sprite atlas layout, in pixels
+constexpr int ATLAS_W = 256;
+constexpr int ATLAS_H = 128;
+constexpr int ATLAS_CIRCLE_X = 0;
+constexpr int ATLAS_TANK_X = 2 * CIRCLE_RADIUS + 2;
+constexpr int ATLAS_UPGRADE_X = ATLAS_TANK_X + 32;
+constexpr int ATLAS_WHITE_X = ATLAS_UPGRADE_X + 32;
+constexpr int ATLAS_WHITE_SIZE = 4;
+
+#define LINE_WIDTH 1.0f
+
+static inline SDL_FRect atlas_region(float x, float y, float w, float h){
+	return {
+		.x = x / ATLAS_W,
+		.y = y / ATLAS_H,
+		.w = w / ATLAS_W,
+		.h = h / ATLAS_H
+	};
+}
+
+static inline SDL_FPoint board_point(const Point& point){
+	return {
+		.x = (float)(double)(DRAW_SCALE * (WALL_WIDTH + point.x)),
+		.y = (float)(double)(DRAW_SCALE * (WALL_WIDTH + point.y))
+	};
+}
+
+static inline float board_length(Number length){
+	return (double)(DRAW_SCALE * length);
+}
+
+static inline SDL_FPoint board_direction(const Point& direction){
+	return {
+		.x = (float)(double)direction.x,
+		.y = (float)(double)direction.y
+	};
+}
+
+void BoardDrawer::init_atlas(SDL_Renderer* renderer){
+	atlas = make_unique<Texture>(renderer,
+		SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
+		ATLAS_W, ATLAS_H
+	);
+	SDL_SetTextureBlendMode(atlas->get(), SDL_BLENDMODE_BLEND);
+
+	int tank_w = DRAW_SCALE * TANK_WIDTH, tank_h = DRAW_SCALE * TANK_LENGTH;
+	int upgrade_size = DRAW_SCALE * UPGRADE_SIZE;
+
+	circle_region = atlas_region(ATLAS_CIRCLE_X, 0, 2 * CIRCLE_RADIUS, 2 * CIRCLE_RADIUS);
+	tank_region = atlas_region(ATLAS_TANK_X, 0, tank_w, tank_h);
+	upgrade_region = atlas_region(ATLAS_UPGRADE_X, 0, upgrade_size, upgrade_size);
+	white_region = atlas_region(ATLAS_WHITE_X + ATLAS_WHITE_SIZE / 2, ATLAS_WHITE_SIZE / 2, 0, 0);
+
+	atlas->do_with_texture(renderer, [&](){
+		SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+		SDL_RenderClear(renderer);
+		
+		vector<SDL_Vertex> vertices;
+		vector<int> indices;
+		vertices.push_back({
+			.position = { .x = ATLAS_CIRCLE_X + CIRCLE_RADIUS, .y = CIRCLE_RADIUS },
+			.color = { .r = 255, .g = 255, .b = 255, .a = 255 },
+			.tex_coord = { .x = 0, .y = 0 }
+		});
+		for(int i = 0; i < CIRCLE_POINTS; i++){
+			double angle = 2 * M_PI * i / CIRCLE_POINTS;
+			vertices.push_back({
+				.position = {
+					.x = ATLAS_CIRCLE_X + CIRCLE_RADIUS * (float)(1 + cos(angle)),
+					.y = CIRCLE_RADIUS * (float)(1 + sin(angle))
+				},
+				.color = { .r = 255, .g = 255, .b = 255, .a = 255 },
+				.tex_coord = { .x = 0, .y = 0 }
+			});
+			indices.push_back(0);
+			indices.push_back(i + 1);
+			indices.push_back((i + 1) % CIRCLE_POINTS + 1);
+		}
+		SDL_RenderGeometry(
+			renderer, NULL,
+			&vertices[0], vertices.size(),
+			&indices[0], indices.size()
+		);
+		
+		SDL_Rect rect;
+		rect.x = ATLAS_TANK_X;
+		rect.y = 0;
+		rect.w = tank_w;
+		rect.h = tank_h;
+		SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+		SDL_RenderFillRect(renderer, &rect);
+		SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+		SDL_RenderDrawRect(renderer, &rect);
+		
+		rect.w = tank_w / 10;
+		rect.h = tank_h / 2;
+		rect.x = ATLAS_TANK_X + (tank_w - rect.w) / 2;
+		rect.y = 0;
+		SDL_RenderFillRect(renderer, &rect);
+		
+		rect.x = ATLAS_UPGRADE_X;
+		rect.y = 0;
+		rect.w = rect.h = upgrade_size;
+		SDL_SetRenderDrawColor(renderer, 224, 224, 224, 255);
+		SDL_RenderFillRect(renderer, &rect);
+		SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+		SDL_RenderDrawRect(renderer, &rect);
+		
+		rect.x = ATLAS_WHITE_X;
+		rect.y = 0;
+		rect.w = rect.h = ATLAS_WHITE_SIZE;
+		SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+		SDL_RenderFillRect(renderer, &rect);
+	});
+}
+
+SDL_Color BoardDrawer::get_owner_color(int owner) const{
+	SDL_Color color = tank_colors[settings.colors[owner]];
+	color.a = 255;
+	return color;
+}
+
+void BoardDrawer::draw(SDL_Renderer* renderer, const Interpolator& interpolator){
+	TRACE_SCOPE("BoardDrawer::draw");
 	if(
 		texture == nullptr ||
 		maze_w != view->get_maze().get_w() ||
 		maze_h != view->get_maze().get_h()
 	) {
+		maze_w = view->get_maze().get_w();
+		maze_h = view->get_maze().get_h();
+
 		texture = make_unique<Texture>(renderer,
 			SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
-			(view->get_maze().get_w() + 2*WALL_WIDTH) * DRAW_SCALE,
-			(view->get_maze().get_h() + 2*WALL_WIDTH) * DRAW_SCALE
+			(maze_w + 2*WALL_WIDTH) * DRAW_SCALE,
+			(maze_h + 2*WALL_WIDTH) * DRAW_SCALE
 		);
-	}
-	
-	if(circle_texture == nullptr){
-		circle_texture = make_unique<Texture>(renderer,
+		wall_texture = make_unique<Texture>(renderer,
 			SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
-			CIRCLE_RADIUS * 2, CIRCLE_RADIUS * 2
+			(maze_w + 2*WALL_WIDTH) * DRAW_SCALE,
+			(maze_h + 2*WALL_WIDTH) * DRAW_SCALE
 		);
-		
-		circle_texture->do_with_texture(renderer, [&](){
-			SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
-			SDL_RenderClear(renderer);
-			
-			vector<SDL_Vertex> vertices;
-			vector<int> indices;
-			vertices.push_back({
-				.position = { .x = CIRCLE_RADIUS, .y = CIRCLE_RADIUS },
-				.color = { .r = 255, .g = 255, .b = 255, .a = 255 },
-				.tex_coord = { .x = 0, .y = 0 }
-			});
-			for(int i = 0; i < CIRCLE_POINTS; i++){
-				double angle = 2 * M_PI * i / CIRCLE_POINTS;
-				vertices.push_back({
-					.position = { .x = CIRCLE_RADIUS * (float)(1 + cos(angle)), .y = CIRCLE_RADIUS * (float)(1 + sin(angle)) },
-					.color = { .r = 255, .g = 255, .b = 255, .a = 255 },
-					.tex_coord = { .x = 0, .y = 0 }
-				});
-				indices.push_back(0);
-				indices.push_back(i + 1);
-				indices.push_back((i + 1) % CIRCLE_POINTS + 1);
-			}
-			SDL_RenderGeometry(
-				renderer, NULL,
-				&vertices[0], vertices.size(),
-				&indices[0], indices.size()
-			);
-		});
+		SDL_SetTextureBlendMode(wall_texture->get(), SDL_BLENDMODE_BLEND);
+		wall_round = -1;
 	}
-	if(tank_texture == nullptr){
-		tank_texture = make_unique<Texture>(renderer,
-			SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
-			DRAW_SCALE * TANK_WIDTH, DRAW_SCALE * TANK_LENGTH
-		);
-		tank_texture->do_with_texture(renderer, [&](){
-			SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+	
+	if(wall_round != view->get_round()){
+		wall_round = view->get_round();
+
+		wall_texture->do_with_texture(renderer, [&](){
+			SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
 			SDL_RenderClear(renderer);
-			
-			SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+
+			SDL_SetRenderDrawColor(renderer, wall_color.r, wall_color.g, wall_color.b, wall_color.a);
 			SDL_Rect rect;
-			rect.x = rect.y = 0;
-			rect.w = DRAW_SCALE * TANK_WIDTH;
-			rect.h = DRAW_SCALE * TANK_LENGTH;
-			SDL_RenderDrawRect(renderer, &rect);
-			
-			rect.w = DRAW_SCALE * TANK_WIDTH / 10;
-			rect.h = DRAW_SCALE * TANK_LENGTH / 2;
-			rect.x = (DRAW_SCALE * TANK_WIDTH - rect.w) / 2;
-			rect.y = 0;
-			SDL_RenderFillRect(renderer, &rect);
+			rect.w = (2 * WALL_WIDTH + 1) * DRAW_SCALE;
+			rect.h = 2 * WALL_WIDTH * DRAW_SCALE;
+			for(int x = 0; x < maze_w; x++){
+				rect.x = x * DRAW_SCALE;
+				for(int y = 0; y <= maze_h; y++){
+					rect.y = y * DRAW_SCALE;
+					if(view->get_maze().has_hwall_below(x, y - 1)) SDL_RenderFillRect(renderer, &rect);
+				}
+			}
+			rect.w = 2 * WALL_WIDTH * DRAW_SCALE;
+			rect.h = (2 * WALL_WIDTH + 1) * DRAW_SCALE;
+			for(int x = 0; x <= maze_w; x++){
+				rect.x = x * DRAW_SCALE;
+				for(int y = 0; y < maze_h; y++){
+					rect.y = y * DRAW_SCALE;
+					if(view->get_maze().has_vwall_right(x - 1, y)) SDL_RenderFillRect(renderer, &rect);
+				}
+			}
 		});
 	}
-	if(upgrade_texture == nullptr){
-		upgrade_texture = make_unique<Texture>(renderer,
-			SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
-			DRAW_SCALE * UPGRADE_SIZE, DRAW_SCALE * UPGRADE_SIZE
-		);
-		upgrade_texture->do_with_texture(renderer, [&](){
-			SDL_SetRenderDrawColor(renderer, 224, 224, 224, 255);
-			SDL_RenderClear(renderer);
-			
-			SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-			SDL_Rect rect;
-			rect.x = rect.y = 0;
-			rect.w = DRAW_SCALE * UPGRADE_SIZE;
-			rect.h = DRAW_SCALE * UPGRADE_SIZE;
-			SDL_RenderDrawRect(renderer, &rect);
-		});
+	
+	if(atlas == nullptr){
+		init_atlas(renderer);
 	}
 	
 	texture->do_with_texture(renderer, [&](){
@@ -124,102 +219,49 @@ void BoardDrawer::draw(SDL_Renderer* renderer){
 		for(const auto& mine: view->get_mines()){
 			if(mine.state == MineState::INACTIVE) continue;
 			
-			SDL_Rect rect;
-			rect.w = 2 * DRAW_SCALE * MINE_SIZE;
-			rect.h = 2 * DRAW_SCALE * MINE_SIZE;
-			rect.x = DRAW_SCALE * (WALL_WIDTH + mine.details.position.x) - rect.w/2;
-			rect.y = DRAW_SCALE * (WALL_WIDTH + mine.details.position.y) - rect.h/2;
-			
-			SDL_SetTextureColorMod(
-				tank_texture->get(),
-				tank_colors[settings.colors[mine.details.owner]].r,
-				tank_colors[settings.colors[mine.details.owner]].g,
-				tank_colors[settings.colors[mine.details.owner]].b
-			);
-			SDL_RenderCopyEx(
-				renderer,
-				tank_texture->get(),
-				NULL, &rect,
-				angle(mine.details.direction), NULL,
-				SDL_FLIP_NONE
+			batch.add_sprite(
+				board_point(mine.details.position),
+				board_length(2 * MINE_SIZE), board_length(2 * MINE_SIZE),
+				board_direction(mine.details.direction),
+				tank_region, get_owner_color(mine.details.owner)
 			);
 		}
-	
-		SDL_SetRenderDrawColor(renderer, wall_color.r, wall_color.g, wall_color.b, wall_color.a);
-		SDL_Rect rect;
-		rect.w = (2 * WALL_WIDTH + 1) * DRAW_SCALE;
-		rect.h = 2 * WALL_WIDTH * DRAW_SCALE;
-		for(int x = 0; x < view->get_maze().get_w(); x++){
-			rect.x = x * DRAW_SCALE;
-			for(int y = 0; y <= view->get_maze().get_h(); y++){
-				rect.y = y * DRAW_SCALE;
-				if(view->get_maze().has_hwall_below(x, y - 1)) SDL_RenderFillRect(renderer, &rect);
-			}
-		}
-		rect.w = 2 * WALL_WIDTH * DRAW_SCALE;
-		rect.h = (2 * WALL_WIDTH + 1) * DRAW_SCALE;
-		for(int x = 0; x <= view->get_maze().get_w(); x++){
-			rect.x = x * DRAW_SCALE;
-			for(int y = 0; y < view->get_maze().get_h(); y++){
-				rect.y = y * DRAW_SCALE;
-				if(view->get_maze().has_vwall_right(x - 1, y)) SDL_RenderFillRect(renderer, &rect);
-			}
-		}
+		batch.draw(renderer, atlas->get());
+		
+		SDL_RenderCopy(renderer, wall_texture->get(), NULL, NULL);
 		
-		SDL_Rect upgrade_rect;
-		upgrade_rect.w = upgrade_rect.h = UPGRADE_SIZE * DRAW_SCALE;
 		for(const auto& upgrade: view->get_upgrades()){
-			upgrade_rect.x = DRAW_SCALE * (upgrade->x + Number(1) / 2 + WALL_WIDTH ) - upgrade_rect.w / 2;
-			upgrade_rect.y = DRAW_SCALE * (upgrade->y + Number(1) / 2 + WALL_WIDTH ) - upgrade_rect.h / 2;
-			
-			SDL_RenderCopyEx(
-				renderer,
-				upgrade_texture->get(),
-				NULL, &upgrade_rect,
-				angle(UPGRADE_ROTATION), NULL,
-				SDL_FLIP_NONE
+			batch.add_sprite(
+				board_point({
+					.x = upgrade->x + Number(1) / 2,
+					.y = upgrade->y + Number(1) / 2
+				}),
+				board_length(UPGRADE_SIZE), board_length(UPGRADE_SIZE),
+				board_direction(UPGRADE_ROTATION),
+				upgrade_region, { .r = 255, .g = 255, .b = 255, .a = 255 }
 			);
 		}
 		
-		auto shots = view->get_shots();
-		for(const auto& shot: shots){
+		for(const auto& shot: view->get_shots()){
 			switch(shot.state.type){
 			case ShotDetails::Type::ROUND:
-				{
-					SDL_Rect shot_rect;
-					shot_rect.w = shot_rect.h = DRAW_SCALE * shot.state.radius * 2;
-					
-					shot_rect.x = DRAW_SCALE * (shot.state.position.x + WALL_WIDTH)- shot_rect.w / 2;
-					shot_rect.y = DRAW_SCALE * (shot.state.position.y + WALL_WIDTH)- shot_rect.h / 2;
-					
-					SDL_SetTextureColorMod(circle_texture->get(), 0, 0, 0);
-					SDL_SetTextureAlphaMod(circle_texture->get(), 255);
-					
-					SDL_RenderCopy(renderer, circle_texture->get(), NULL, &shot_rect);
-				}
+				batch.add_sprite(
+					board_point(interpolator.get_shot(shot)),
+					board_length(2 * shot.state.radius), board_length(2 * shot.state.radius),
+					{ .x = 0, .y = -1 },
+					circle_region, { .r = 0, .g = 0, .b = 0, .a = 255 }
+				);
 				break;
 			case ShotDetails::Type::LASER:
 				{
-					SDL_SetRenderDrawColor(
-						renderer,
-						tank_colors[settings.colors[shot.state.owner]].r,
-						tank_colors[settings.colors[shot.state.owner]].g,
-						tank_colors[settings.colors[shot.state.owner]].b,
-						255
-					);
-					vector<SDL_Point> points;
-					for(const auto& point: shot.path){
-						points.push_back({
-							.x = DRAW_SCALE * (point.point.x + WALL_WIDTH),
-							.y = DRAW_SCALE * (point.point.y + WALL_WIDTH)
-						});
+					auto color = get_owner_color(shot.state.owner);
+					for(int i = 0; i < shot.path.size(); i++){
+						batch.add_line(
+							board_point(shot.path[i].point),
+							board_point(i + 1 < shot.path.size() ? shot.path[i + 1].point : shot.state.position),
+							LINE_WIDTH, white_region, color
+						);
 					}
-					points.push_back({
-						.x = DRAW_SCALE * (shot.state.position.x + WALL_WIDTH),
-						.y = DRAW_SCALE * (shot.state.position.y + WALL_WIDTH)
-					});
-					
-					SDL_RenderDrawLines(renderer, &points[0], points.size());
 				}
 				break;
 			}
@@ -230,16 +272,11 @@ void BoardDrawer::draw(SDL_Renderer* renderer){
 			if(start_fraction > shrapnel->collision) start_fraction = shrapnel->collision;
 			auto end_fraction = get_shrapnel_way(shrapnel->timer);
 			if(end_fraction > shrapnel->collision) end_fraction = shrapnel->collision;
-			auto start = shrapnel->details.start + shrapnel->details.distance * start_fraction;
-			auto end = shrapnel->details.start + shrapnel->details.distance * end_fraction;
 			
-			SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);			
-			SDL_RenderDrawLine(
-				renderer,
-				DRAW_SCALE * (WALL_WIDTH + start.x),
-				DRAW_SCALE * (WALL_WIDTH + start.y),
-				DRAW_SCALE * (WALL_WIDTH + end.x),
-				DRAW_SCALE * (WALL_WIDTH + end.y)
+			batch.add_line(
+				board_point(shrapnel->details.start + shrapnel->details.distance * start_fraction),
+				board_point(shrapnel->details.start + shrapnel->details.distance * end_fraction),
+				LINE_WIDTH, white_region, { .r = 0, .g = 0, .b = 0, .a = 255 }
 			);
 		}
 		
@@ -247,80 +284,49 @@ void BoardDrawer::draw(SDL_Renderer* renderer){
 		for(int i = 0; i < tank_states.size(); i++){
 			if(!tank_states[i].state.alive) continue;
 			
-			SDL_Rect tank_rect;
-			tank_rect.w = DRAW_SCALE * TANK_WIDTH;
-			tank_rect.h = DRAW_SCALE * TANK_LENGTH;
-			tank_rect.x = (tank_states[i].state.position.x + WALL_WIDTH) * DRAW_SCALE - tank_rect.w / 2;
-			tank_rect.y = (tank_states[i].state.position.y + WALL_WIDTH) * DRAW_SCALE - tank_rect.h / 2;
-			
-			SDL_SetTextureColorMod(
-				tank_texture->get(),
-				tank_colors[settings.colors[i]].r,
-				tank_colors[settings.colors[i]].g,
-				tank_colors[settings.colors[i]].b
-			);
-			SDL_RenderCopyEx(
-				renderer,
-				tank_texture->get(),
-				NULL, &tank_rect,
-				angle(tank_states[i].state.direction), NULL,
-				SDL_FLIP_NONE
+			Motion motion = interpolator.get_tank(i, tank_states[i].state);
+			batch.add_sprite(
+				board_point(motion.position),
+				board_length(TANK_WIDTH), board_length(TANK_LENGTH),
+				board_direction(motion.direction),
+				tank_region, get_owner_color(i)
 			);
 		}
 		
 		for(const auto& missile: view->get_missiles()){
-			SDL_Rect missile_rect;
-			missile_rect.w = DRAW_SCALE * MISSILE_WIDTH;
-			missile_rect.h = DRAW_SCALE * MISSILE_LENGTH;
-			missile_rect.x = (missile.state.position.x + WALL_WIDTH) * DRAW_SCALE - missile_rect.w / 2;
-			missile_rect.y = (missile.state.position.y + WALL_WIDTH) * DRAW_SCALE - missile_rect.h / 2;
-			
-			SDL_SetTextureColorMod(
-				tank_texture->get(),
-				tank_colors[settings.colors[missile.state.owner]].r,
-				tank_colors[settings.colors[missile.state.owner]].g,
-				tank_colors[settings.colors[missile.state.owner]].b
-			);
-			SDL_RenderCopyEx(
-				renderer,
-				tank_texture->get(),
-				NULL, &missile_rect,
-				angle(missile.state.direction), NULL,
-				SDL_FLIP_NONE
+			Motion motion = interpolator.get_missile(missile.id, missile.state);
+			batch.add_sprite(
+				board_point(motion.position),
+				board_length(MISSILE_WIDTH), board_length(MISSILE_LENGTH),
+				board_direction(motion.direction),
+				tank_region, get_owner_color(missile.state.owner)
 			);
 		}
 		
 		for(const auto& death_ray: view->get_death_rays()){
-			SDL_SetRenderDrawColor(
-				renderer,
-				tank_colors[settings.colors[death_ray.path.owner]].r,
-				tank_colors[settings.colors[death_ray.path.owner]].g,
-				tank_colors[settings.colors[death_ray.path.owner]].b,
-				255
-			);
-			
-			vector<SDL_Point> line;
-			for(const auto& point: death_ray.path.path){
-				line.push_back({
-					.x = DRAW_SCALE * (WALL_WIDTH + point.x),
-					.y = DRAW_SCALE * (WALL_WIDTH + point.y)
-				});
+			auto color = get_owner_color(death_ray.path.owner);
+			for(int i = 0; i + 1 < death_ray.path.path.size(); i++){
+				batch.add_line(
+					board_point(death_ray.path.path[i]),
+					board_point(death_ray.path.path[i + 1]),
+					LINE_WIDTH, white_region, color
+				);
 			}
-			
-			SDL_RenderDrawLines(
-				renderer,
-				&line[0],
-				line.size()
-			);
 		}
+		
+		batch.draw(renderer, atlas->get());
 	});
 }
 
+void BoardDrawer::set_view(const GameView* view){
+	this->view = view;
+}
+
 Texture& BoardDrawer::get_texture() const{
 	return *texture;
 }
 
-GameDrawer::GameDrawer(GameView* view, const GameSettings& settings) :
+GameDrawer::GameDrawer(const GameView* view, const GameSettings& settings) :
 	view(view),
 	settings(settings),
 	board_drawer(view, settings),
@@ -339,13 +345,14 @@ void GameDrawer::init(SDL_Renderer* renderer){
 	}
 }
 
-void GameDrawer::draw(SDL_Renderer* renderer){
+void GameDrawer::draw(SDL_Renderer* renderer, double tick_fraction){
 	init(renderer);
+	interpolator.set_fraction(tick_fraction);
 
 	SDL_SetRenderDrawColor(renderer, bg_color.r, bg_color.g, bg_color.b, bg_color.a);
 	SDL_RenderClear(renderer);
 	
-	board_drawer.draw(renderer);
+	board_drawer.draw(renderer, interpolator);
 	SDL_Rect board_rect;
 	int w, h;
 	SDL_QueryTexture(board_drawer.get_texture().get(), NULL, NULL, &w, &h);
@@ -361,6 +368,11 @@ void GameDrawer::draw(SDL_Renderer* renderer){
     SDL_RenderCopy(renderer, board_drawer.get_texture().get(), NULL, &board_rect);
 }
 
-void GameDrawer::step(){
+void GameDrawer::set_view(const GameView* view){
+	this->view = view;
+	board_drawer.set_view(view);
+}
 
+void GameDrawer::step(int tick){
+	interpolator.update(*view, tick);
 }
\ No newline at end of file
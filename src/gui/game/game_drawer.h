@@ -5,6 +5,9 @@
 #include "../../game/interface/game_view.h"
 
 #include "../utils/utils.h"
+#include "../utils/geometry_batch.h"
+
+#include "interpolation.h"
 
 #include <memory>
 #include <SDL.h>
@@ -12,17 +15,26 @@
 class BoardDrawer{
 	const GameSettings& settings;
 
-	GameView* view;
+	const GameView* view;
 
 	int maze_w, maze_h;
 	unique_ptr<Texture> texture;
 
-	unique_ptr<Texture> tank_texture, upgrade_texture;  // Temp
-	unique_ptr<Texture> circle_texture;
+	int wall_round;
+	unique_ptr<Texture> wall_texture;  // Static maze layer, redrawn only when the round changes
+
+	unique_ptr<Texture> atlas;
+	SDL_FRect tank_region, upgrade_region, circle_region, white_region;
+	GeometryBatch batch;
+
+	void init_atlas(SDL_Renderer* renderer);
+	SDL_Color get_owner_color(int owner) const;
 public:
-	BoardDrawer(GameView* view, const GameSettings& settings);
+	BoardDrawer(const GameView* view, const GameSettings& settings);
+
+	void set_view(const GameView* view);
 	
-	void draw(SDL_Renderer* renderer);
+	void draw(SDL_Renderer* renderer, const Interpolator& interpolator);
 	
 	Texture& get_texture() const;
 };
@@ -30,18 +42,21 @@ public:
 class GameDrawer{
 	const GameSettings& settings;
 
-	GameView* view;
+	const GameView* view;
 
 	BoardDrawer board_drawer;
+	Interpolator interpolator;
 	bool is_initialized;
 	int screen_width, screen_height;
 
 	void init(SDL_Renderer* renderer);
 public:
-	GameDrawer(GameView* view, const GameSettings& settings);
+	GameDrawer(const GameView* view, const GameSettings& settings);
+
+	void set_view(const GameView* view);
 	
-	void draw(SDL_Renderer* renderer);
-	void step();
+	void draw(SDL_Renderer* renderer, double tick_fraction);
+	void step(int tick);
 };
 
 #endif
@@ -7,28 +7,15 @@ GameGui::GameGui(
 	map<PlayerInterface*, unique_ptr<Controller>>&& controllers
 ) :
 	settings(settings),
-	drawer(view, this->settings),
-	view(view),
-	advancer(advancer),
-	controllers(move(controllers)) {
+	controllers(move(controllers)),
+	simulation(view, advancer, this->controllers),
+	drawer(&simulation.get_frame().snapshot, this->settings) {
 
 }
 
 GameGui::~GameGui(){
 }
 
-bool GameGui::step(){
-	for(auto& entry: controllers){
-		entry.first->step(view->get_round(), entry.second->get_state());
-	}
-	
-	advancer->allow_step();
-	advancer->advance();
-
-	drawer.step();
-	return false;
-}
-
 bool GameGui::handle_event(const SDL_Event& event){
 	switch(event.type){
 	case SDL_KEYDOWN:
@@ -45,5 +32,9 @@ bool GameGui::handle_event(const SDL_Event& event){
 }
 
 void GameGui::draw(SDL_Renderer* renderer){
-	drawer.draw(renderer);
+	if(simulation.update()){
+		drawer.set_view(&simulation.get_frame().snapshot);
+		drawer.step(simulation.get_frame().tick);
+	}
+	drawer.draw(renderer, simulation.get_tick_fraction());
 }
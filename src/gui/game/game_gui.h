@@ -11,6 +11,7 @@
 #include "../controls/controller.h"
 
 #include "game_drawer.h"
+#include "simulation_thread.h"
 
 #include <memory>
 #include <map>
@@ -19,12 +20,11 @@ using namespace std;
 
 class GameGui : public Gui{
 	const GameSettings settings;
-	
-	GameDrawer drawer;
 
-	GameView* view;
-	GameAdvancer* advancer;
 	map<PlayerInterface*, unique_ptr<Controller>> controllers;
+	SimulationThread simulation;
+
+	GameDrawer drawer;
 
 public:
 	GameGui(
@@ -42,7 +42,6 @@ public:
 	GameGui& operator=(GameGui&&) = delete;
 	GameGui& operator=(const GameGui&) = delete;
 
-	bool step();
 	bool handle_event(const SDL_Event& event);
 	void draw(SDL_Renderer* renderer);
 };
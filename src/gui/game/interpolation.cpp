@@ -0,0 +1,103 @@
+#include "interpolation.h"
+
+#include "../../game/logic/geometry.h"
+
+#include <algorithm>
+
+static inline Point blend(const Point& start, const Point& end, double fraction){
+	return start + (end - start) * fraction;
+}
+
+static inline Motion blend(const Motion& start, const Motion& end, double fraction){
+	return {
+		.position = blend(start.position, end.position, fraction),
+		// Directions flipped by a bounce are not blended through zero
+		.direction = dot(start.direction, end.direction) < 0 ?
+			end.direction :
+			blend(start.direction, end.direction, fraction)
+	};
+}
+
+Interpolator::Interpolator() : round(-1), previous_tick(0), current_tick(0), fraction(1), blend_fraction(1) {}
+
+void Interpolator::update(const GameView& view, int tick){
+	bool new_round = view.get_round() != round;
+	round = view.get_round();
+	previous_tick = current_tick;
+	current_tick = tick;
+
+	swap(previous_tanks, current_tanks);
+	current_tanks.clear();
+	for(const auto& tank: view.get_states()){
+		current_tanks.push_back({
+			.position = tank.state.position,
+			.direction = tank.state.direction
+		});
+	}
+
+	swap(previous_missiles, current_missiles);
+	current_missiles.clear();
+	for(const auto& missile: view.get_missiles()){
+		current_missiles.push_back({missile.id, {
+			.position = missile.state.position,
+			.direction = missile.state.direction
+		}});
+	}
+	sort(
+		current_missiles.begin(), current_missiles.end(),
+		[](const pair<int, Motion>& entry1, const pair<int, Motion>& entry2){ return entry1.first < entry2.first; }
+	);
+
+	if(new_round){
+		previous_tanks = current_tanks;
+		previous_missiles = current_missiles;
+		previous_tick = current_tick - 1;
+	}
+}
+
+void Interpolator::set_fraction(double fraction){
+	this->fraction = fraction < 0 ? 0 : (fraction > 1 ? 1 : fraction);
+
+	// Drawn a tick behind: at the start of the last tick, all but one of the skipped ticks are behind
+	int ticks = current_tick - previous_tick;
+	blend_fraction = ticks > 1 ? (ticks - 1 + this->fraction) / ticks : this->fraction;
+}
+
+Motion Interpolator::get_tank(int index, const TankState& state) const{
+	Motion current = {
+		.position = state.position,
+		.direction = state.direction
+	};
+	if(index >= previous_tanks.size()) return current;
+
+	return blend(previous_tanks[index], current, blend_fraction);
+}
+
+Motion Interpolator::get_missile(int id, const MissileDetails& state) const{
+	Motion current = {
+		.position = state.position,
+		.direction = state.direction
+	};
+
+	auto previous = lower_bound(
+		previous_missiles.begin(), previous_missiles.end(), id,
+		[](const pair<int, Motion>& entry, int id){ return entry.first < id; }
+	);
+	if(previous == previous_missiles.end() || previous->first != id) return current;
+
+	return blend(previous->second, current, blend_fraction);
+}
+
+Point Interpolator::get_shot(const ShotPath& shot) const{
+	// The path holds every point the shot passed during the last tick, with the tick fraction left at each
+	for(int i = 0; i < shot.path.size(); i++){
+		Number start_time = Number(1) - shot.path[i].time;
+		Number end_time = i + 1 < shot.path.size() ? Number(1) - shot.path[i + 1].time : Number(1);
+		if(fraction > (double)end_time && i + 1 < shot.path.size()) continue;
+
+		const Point& end = i + 1 < shot.path.size() ? shot.path[i + 1].point : shot.state.position;
+		if(end_time <= start_time) return end;
+		return blend(shot.path[i].point, end, (fraction - (double)start_time) / (double)(end_time - start_time));
+	}
+	return shot.state.position;
+}
@@ -0,0 +1,37 @@
+#ifndef _INTERPOLATION_H
+#define _INTERPOLATION_H
+
+#include "../../game/interface/game_view.h"
+#include "../../utils/numbers.h"
+
+#include <vector>
+#include <utility>
+
+using namespace std;
+
+struct Motion{
+	Point position;
+	Point direction;
+};
+
+// Blends moving objects between the last two snapshots, which may be several ticks apart
+class Interpolator{
+	int round;
+	int previous_tick, current_tick;
+	double fraction;  // Of the last tick, what shot paths cover
+	double blend_fraction;  // Of the ticks between the snapshots
+
+	vector<Motion> previous_tanks, current_tanks;
+	vector<pair<int, Motion>> previous_missiles, current_missiles;
+public:
+	Interpolator();
+
+	void update(const GameView& view, int tick);
+	void set_fraction(double fraction);
+
+	Motion get_tank(int index, const TankState& state) const;
+	Motion get_missile(int id, const MissileDetails& state) const;
+	Point get_shot(const ShotPath& shot) const;
+};
+
+#endif
@@ -0,0 +1,74 @@
+#include "simulation_thread.h"
+
+#include "../../utils/trace.h"
+
+SimulationThread::SimulationThread(
+	GameView* view,
+	GameAdvancer* advancer,
+	map<PlayerInterface*, unique_ptr<Controller>>& controllers
+) :
+	view(view),
+	advancer(advancer),
+	controllers(controllers),
+	tick(0),
+	running(true) {
+
+	publish();
+	update();
+
+	worker = thread(&SimulationThread::run, this);
+}
+
+SimulationThread::~SimulationThread(){
+	running.store(false, memory_order_relaxed);
+	worker.join();
+}
+
+void SimulationThread::publish(){
+	auto& frame = frames.get_back();
+	frame.snapshot.capture(*view);
+	frame.time = chrono::steady_clock::now();
+	frame.tick = tick;
+	frames.publish();
+}
+
+void SimulationThread::run(){
+	TRACE_THREAD_NAME("simulation");
+
+	auto tick_len = chrono::duration_cast<chrono::steady_clock::duration>(
+		chrono::duration<double, milli>(SIMULATION_TICK_LEN)
+	);
+	auto next_tick = chrono::steady_clock::now();
+
+	while(running.load(memory_order_relaxed)){
+		next_tick += tick_len;
+		this_thread::sleep_until(next_tick);
+
+		for(auto& entry: controllers){
+			entry.first->step(view->get_round(), entry.second->get_state());
+		}
+		advancer->allow_step();
+		advancer->advance();
+		tick++;
+
+		publish();
+
+		auto now = chrono::steady_clock::now();
+		if(now - next_tick > tick_len * SIMULATION_MAX_LAG_TICKS){
+			next_tick = now;  // Too far behind, drop the missed ticks instead of bursting through them
+		}
+	}
+}
+
+bool SimulationThread::update(){
+	return frames.update();
+}
+
+const SimulationFrame& SimulationThread::get_frame() const{
+	return frames.get_front();
+}
+
+double SimulationThread::get_tick_fraction() const{
+	chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - get_frame().time;
+	return elapsed.count() / SIMULATION_TICK_LEN;
+}
@@ -0,0 +1,65 @@
+#ifndef _SIMULATION_THREAD_H
+#define _SIMULATION_THREAD_H
+
+#include "../../game/interface/game_view.h"
+#include "../../game/interface/game_advancer.h"
+#include "../../game/interface/player_interface.h"
+#include "../../game/interface/game_snapshot.h"
+
+#include "../../utils/triple_buffer.h"
+
+#include "../controls/controller.h"
+
+#include <memory>
+#include <map>
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+using namespace std;
+
+#define SIMULATION_TICK_LEN (1000.0 / 60.0)
+#define SIMULATION_MAX_LAG_TICKS 5
+
+struct SimulationFrame{
+	GameSnapshot snapshot;
+	chrono::steady_clock::time_point time;
+	int tick;  // Ticks advanced before the snapshot, the render thread may skip some of the frames
+};
+
+// Advances the game at a fixed tick rate on its own thread and hands complete
+// snapshots to the render thread
+class SimulationThread{
+	GameView* view;
+	GameAdvancer* advancer;
+	map<PlayerInterface*, unique_ptr<Controller>>& controllers;
+
+	TripleBuffer<SimulationFrame> frames;
+	int tick;
+	atomic<bool> running;
+	thread worker;
+
+	void publish();
+	void run();
+public:
+	SimulationThread(
+		GameView* view,
+		GameAdvancer* advancer,
+		map<PlayerInterface*, unique_ptr<Controller>>& controllers
+	);
+
+	SimulationThread(SimulationThread&&) = delete;
+	SimulationThread(const SimulationThread&) = delete;
+
+	~SimulationThread();
+
+	SimulationThread& operator=(SimulationThread&&) = delete;
+	SimulationThread& operator=(const SimulationThread&) = delete;
+
+	// Render thread side
+	bool update();
+	const SimulationFrame& get_frame() const;
+	double get_tick_fraction() const;
+};
+
+#endif
@@ -2,15 +2,20 @@
 
 #include "utils/clock.h"
 
-#define TICK_LEN (1000.0 / 60.0)
+#include "../utils/trace.h"
 
+#define MIN_FRAME_LEN (1000.0 / 250.0)
+
+// The game advances on the simulation thread, frames only draw its latest state and handle input
 void mainloop(Gui& gui, SDL_Renderer* renderer){
-	Clock clock;
+	Clock frame_clock;
 	
 	while(true){
 		gui.draw(renderer);
 		
+		TRACE_BEGIN("SDL_RenderPresent");
 		SDL_RenderPresent(renderer);
+		TRACE_END("SDL_RenderPresent");
 		
 		SDL_Event event;
 		
@@ -19,8 +24,6 @@ void mainloop(Gui& gui, SDL_Renderer* renderer){
 			if(gui.handle_event(event)) return;
 		}
 		
-		gui.step();
-		
-		clock.tick(TICK_LEN);
+		frame_clock.tick(MIN_FRAME_LEN);
 	}
-}
\ No newline at end of file
+}
@@ -5,7 +5,6 @@
 
 class Gui{
 public:
-	virtual bool step() = 0;
 	virtual bool handle_event(const SDL_Event& event) = 0;
 	virtual void draw(SDL_Renderer* renderer) = 0;
 };
@@ -2,11 +2,14 @@
 
 #include <SDL.h>
 
+#include "../../utils/trace.h"
+
 Clock::Clock() :
 	last_tick(SDL_GetTicks()),
 	remainder(0) {}
 
 void Clock::tick(double length){
+	TRACE_SCOPE("Clock::tick");
 	int time = SDL_GetTicks();
 	int diff = time - last_tick;
 	
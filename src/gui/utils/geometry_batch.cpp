@@ -0,0 +1,62 @@
+#include "geometry_batch.h"
+
+#include <math.h>
+
+void GeometryBatch::add_quad(const SDL_FPoint (&corners)[4], const SDL_FRect& source, SDL_Color color){
+	int first = vertices.size();
+
+	vertices.push_back({ .position = corners[0], .color = color, .tex_coord = { .x = source.x, .y = source.y } });
+	vertices.push_back({ .position = corners[1], .color = color, .tex_coord = { .x = source.x + source.w, .y = source.y } });
+	vertices.push_back({ .position = corners[2], .color = color, .tex_coord = { .x = source.x + source.w, .y = source.y + source.h } });
+	vertices.push_back({ .position = corners[3], .color = color, .tex_coord = { .x = source.x, .y = source.y + source.h } });
+
+	indices.push_back(first);
+	indices.push_back(first + 1);
+	indices.push_back(first + 2);
+	indices.push_back(first);
+	indices.push_back(first + 2);
+	indices.push_back(first + 3);
+}
+
+void GeometryBatch::add_sprite(
+	SDL_FPoint center, float width, float height, SDL_FPoint direction,
+	const SDL_FRect& source, SDL_Color color
+){
+	float direction_length = sqrt(direction.x * direction.x + direction.y * direction.y);
+	if(direction_length == 0) return;
+
+	// The top of the source rectangle faces the direction
+	SDL_FPoint forward = { .x = direction.x / direction_length * height / 2, .y = direction.y / direction_length * height / 2 };
+	SDL_FPoint right = { .x = -direction.y / direction_length * width / 2, .y = direction.x / direction_length * width / 2 };
+
+	add_quad({
+		{ .x = center.x - right.x + forward.x, .y = center.y - right.y + forward.y },
+		{ .x = center.x + right.x + forward.x, .y = center.y + right.y + forward.y },
+		{ .x = center.x + right.x - forward.x, .y = center.y + right.y - forward.y },
+		{ .x = center.x - right.x - forward.x, .y = center.y - right.y - forward.y }
+	}, source, color);
+}
+
+void GeometryBatch::add_line(SDL_FPoint start, SDL_FPoint end, float width, const SDL_FRect& source, SDL_Color color){
+	SDL_FPoint direction = { .x = start.x - end.x, .y = start.y - end.y };
+	float length = sqrt(direction.x * direction.x + direction.y * direction.y);
+	if(length == 0) return;
+
+	add_sprite({
+		.x = (start.x + end.x) / 2,
+		.y = (start.y + end.y) / 2
+	}, width, length, direction, source, color);
+}
+
+void GeometryBatch::draw(SDL_Renderer* renderer, SDL_Texture* texture){
+	if(!indices.empty()){
+		SDL_RenderGeometry(
+			renderer, texture,
+			&vertices[0], vertices.size(),
+			&indices[0], indices.size()
+		);
+	}
+
+	vertices.clear();
+	indices.clear();
+}
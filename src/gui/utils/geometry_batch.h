@@ -0,0 +1,25 @@
+#ifndef _GEOMETRY_BATCH_H
+#define _GEOMETRY_BATCH_H
+
+#include <SDL.h>
+
+#include <vector>
+
+using namespace std;
+
+// Collects textured, per-vertex colored quads and submits them in one draw call
+class GeometryBatch{
+	vector<SDL_Vertex> vertices;
+	vector<int> indices;
+public:
+	void add_quad(const SDL_FPoint (&corners)[4], const SDL_FRect& source, SDL_Color color);
+	void add_sprite(
+		SDL_FPoint center, float width, float height, SDL_FPoint direction,
+		const SDL_FRect& source, SDL_Color color
+	);
+	void add_line(SDL_FPoint start, SDL_FPoint end, float width, const SDL_FRect& source, SDL_Color color);
+
+	void draw(SDL_Renderer* renderer, SDL_Texture* texture);
+};
+
+#endif
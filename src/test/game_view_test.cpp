@@ -0,0 +1,104 @@
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <vector>
+
+#include "test.h"
+
+#include "../game/logic/game.h"
+#include "../game/batch/observation_encoder.h"
+#include "../utils/utils.h"
+
+using namespace std;
+
+#define TEST_SEED 4321
+#define TEST_TANKS 4
+#define TEST_TICKS 3000
+
+// Every heap allocation of the process is counted, reading the world must not add to it
+static uint64_t allocation_count = 0;
+
+void* operator new(size_t size){
+	void* result = malloc(size ? size : 1);
+	if(result == nullptr) throw bad_alloc();
+	allocation_count++;
+	return result;
+}
+void* operator new[](size_t size){
+	return operator new(size);
+}
+void operator delete(void* pointer) noexcept{
+	free(pointer);
+}
+void operator delete[](void* pointer) noexcept{
+	free(pointer);
+}
+void operator delete(void* pointer, size_t) noexcept{
+	free(pointer);
+}
+void operator delete[](void* pointer, size_t) noexcept{
+	free(pointer);
+}
+
+// Touches everything a view exposes, the way a drawer or an agent would
+static int read_view(const GameView& view){
+	int objects = 0;
+	for(const auto& tank: view.get_states()) objects += tank.state.alive + (tank.upgrade != nullptr);
+	for(const auto& shot: view.get_shots()) objects += shot.path.size() + (shot.state.owner >= 0);
+	for(const auto& missile: view.get_missiles()) objects += missile.target >= 0;
+	for(auto shrapnel: view.get_shrapnels()) objects += shrapnel->timer > 0;
+	for(const auto& mine: view.get_mines()) objects += mine.details.owner >= 0;
+	for(const auto& death_ray: view.get_death_rays()) objects += death_ray.timer > 0;
+	objects += view.get_upgrades().size();
+	return objects;
+}
+
+int main(){
+	seed_random(TEST_SEED);
+	Game game(MazeGeneration::EXPAND_TREE, {
+		Upgrade::Type::GATLING, Upgrade::Type::LASER, Upgrade::Type::BOMB, Upgrade::Type::RC_MISSILE,
+		Upgrade::Type::HOMING_MISSILE, Upgrade::Type::MINES, Upgrade::Type::DEATH_RAY
+	}, TEST_TANKS);
+	mt19937 keys(TEST_SEED);
+	const GameView& view = game;
+	const ObservationEncoder encoder;
+	vector<float> observations(TEST_TANKS * encoder.get_size());
+	vector<int16_t> fixed_observations(TEST_TANKS * encoder.get_size());
+
+	uint64_t read_allocations = 0, encode_allocations = 0, advance_allocations = 0;
+	int objects = 0, moved_spans = 0;
+	for(int tick = 0; tick < TEST_TICKS; tick++){
+		for(int i = 0; i < TEST_TANKS; i++){
+			unsigned int bits = keys();
+			KeyState key(bits % 3 == 0, bits / 3 % 4 == 0, bits / 12 % 2 == 0, bits / 24 % 5 == 0, bits / 120 % 90 == 0);
+			game.get_player_interface(i).step(game.get_round(), key);
+		}
+
+		uint64_t before = allocation_count;
+		game.advance();
+		advance_allocations += allocation_count - before;
+
+		before = allocation_count;
+		auto states = view.get_states();
+		auto shots = view.get_shots();
+		objects += read_view(view);
+		read_allocations += allocation_count - before;
+
+		// The observation encoder reads the world and the round's routes the same way
+		before = allocation_count;
+		encoder.encode(game, observations.data());
+		encoder.encode(game, fixed_observations.data());
+		encode_allocations += allocation_count - before;
+
+		// Spans held from an earlier call stay the same after the getters are called again
+		moved_spans += view.get_states().begin() != states.begin() || view.get_states().size() != states.size();
+		moved_spans += view.get_shots().begin() != shots.begin() || view.get_shots().size() != shots.size();
+	}
+
+	CHECK(objects > 0);
+	CHECK_EQUAL(read_allocations, (uint64_t)0);
+	CHECK_EQUAL(encode_allocations, (uint64_t)0);
+	CHECK_EQUAL(moved_spans, 0);
+	cerr << "game_view_test: " << (double)advance_allocations / TEST_TICKS << " allocations per advance" << endl;
+	return test_result("game_view_test");
+}
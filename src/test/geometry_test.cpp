@@ -0,0 +1,69 @@
+#include "test.h"
+
+#include "../game/logic/geometry.h"
+#include "../game/logic/logic.h"
+
+using namespace std;
+
+// A contact whose normal passes through the center has no arm to rotate around.
+// Rotating can't resolve it, and it used to divide by zero.
+static void test_zero_arm_contact(){
+	const Point center = { .x = 1, .y = 1 };
+	const Point direction = { .x = 0, .y = 1 };
+
+	Collision through_center = {
+		.position = { .x = 1, .y = Number(5) / 4 },
+		.normal = { .x = 0, .y = 1 },
+		.depth = Number(1) / 100
+	};
+	Point rotated = direction;
+	CHECK(!collision_rotate(Span<Collision>(&through_center, 1), center, rotated, 2 * TURN_SIN));
+	CHECK((double)rotated.x == 0 && (double)rotated.y == 1);
+
+	// Touching without depth needs no rotation, the other contacts still decide
+	Collision contacts[] = {
+		{
+			.position = { .x = 1, .y = Number(5) / 4 },
+			.normal = { .x = 0, .y = 1 },
+			.depth = 0
+		},
+		{
+			.position = { .x = Number(9) / 8, .y = Number(5) / 4 },
+			.normal = { .x = 0, .y = 1 },
+			.depth = Number(1) / 1000
+		}
+	};
+	rotated = direction;
+	CHECK(collision_rotate(Span<Collision>(contacts, 2), center, rotated, 2 * TURN_SIN));
+	CHECK((double)rotated.x > 0);
+}
+
+// A tank driving straight at the end of a wall, centered on its corner, makes such a contact
+static void test_tank_into_wall_end(){
+	Maze maze({ { true }, { false } }, { { false, false } });
+	const Point start = { .x = 1 + WALL_WIDTH, .y = Number(89) / 128 };
+	TankState tank(start, get_heading_direction(18), 18, KeyState(false, false, true, false, false), true, true);
+
+	advance_tank(tank, maze);
+	CHECK((double)tank.position.x == (double)start.x && (double)tank.position.y == (double)start.y);
+	CHECK_EQUAL(tank.heading, 18);
+}
+
+// Shots on the heading table often move exactly along the walls' edges, they used to pass through them
+static void test_shot_along_axis(){
+	Maze maze({ { false }, { false } }, { { true, false } });
+	const Point start = { .x = Number(3) / 2, .y = Number(1) / 2 };
+	ShotDetails shot(start, get_heading_direction(36), Number(1) / 50, 0, ShotDetails::Type::ROUND, 0);
+	int ignored_tank = -1;
+	vector<TimePoint> path;
+	advance_shot(shot, maze, {}, ignored_tank, path);
+	CHECK_EQUAL((int)path.size(), 2);
+	CHECK((double)shot.position.x > 1);
+}
+
+int main(){
+	test_zero_arm_contact();
+	test_tank_into_wall_end();
+	test_shot_along_axis();
+	return test_result("geometry_test");
+}
@@ -0,0 +1,156 @@
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "test.h"
+
+#include "../game/logic/game.h"
+#include "../game/replay/replay.h"
+#include "../utils/utils.h"
+#include "../utils/serialization.h"
+
+using namespace std;
+
+#define TEST_SEED 1234
+#define TEST_TANKS 3
+#define TEST_TICKS 2000
+#define TEST_KEYFRAME_INTERVAL 250
+
+// Plays a seeded match with random keys into a replay, the third tank leaves for a while.
+// desync_tick, when set, reseeds the shared random engine there, as a peer drifting apart would.
+// Returns the state hash of every tick, starting with the state before the first step.
+static vector<uint64_t> record(const string& filename, int desync_tick = -1){
+	seed_random(TEST_SEED);
+	Game game(MazeGeneration::EXPAND_TREE, {
+		Upgrade::Type::GATLING, Upgrade::Type::LASER, Upgrade::Type::BOMB, Upgrade::Type::RC_MISSILE,
+		Upgrade::Type::HOMING_MISSILE, Upgrade::Type::MINES, Upgrade::Type::DEATH_RAY
+	}, TEST_TANKS);
+	mt19937 keys(TEST_SEED);
+
+	vector<uint64_t> state_hashes;
+	ReplayWriter writer(filename.c_str(), game, TEST_KEYFRAME_INTERVAL);
+	CHECK(writer.is_open());
+
+	state_hashes.push_back(game.get_state_hash());
+	for(int tick = 0; tick < TEST_TICKS; tick++){
+		if(tick == 700) game.get_player_interface(2).set_active(false);
+		if(tick == 1100) game.get_player_interface(2).set_active(true);
+		if(tick == desync_tick) seed_random(TEST_SEED + 1);
+
+		for(int i = 0; i < TEST_TANKS; i++){
+			unsigned int bits = keys();
+			if(i == 2 && tick >= 700 && tick < 1100) continue;
+			KeyState key(bits % 3 == 0, bits / 3 % 4 == 0, bits / 12 % 2 == 0, bits / 24 % 5 == 0, bits / 120 % 90 == 0);
+			game.get_player_interface(i).step(game.get_round(), key);
+		}
+		game.advance();
+
+		state_hashes.push_back(game.get_state_hash());
+	}
+	writer.close();
+	return state_hashes;
+}
+
+static void test_playback(const string& filename){
+	auto state_hashes = record(filename);
+
+	ReplayPlayer player(filename.c_str());
+	CHECK(player.is_open());
+	CHECK_EQUAL(player.get_tick_count(), TEST_TICKS);
+
+	// Stepping through the whole match replays every recorded state
+	player.seek(0);
+	CHECK_EQUAL(player.get_tick(), 0);
+	CHECK_EQUAL(player.get_state_hash(), state_hashes[0]);
+	int mismatches = 0;
+	while(player.step()){
+		if(player.get_state_hash() != state_hashes[player.get_tick()]) mismatches++;
+	}
+	CHECK_EQUAL(player.get_tick(), TEST_TICKS);
+	CHECK_EQUAL(mismatches, 0);
+	CHECK_EQUAL(player.get_desync_tick(), -1);
+
+	// Seeking backwards and forwards, onto keyframes and on both sides of them
+	for(int target: {
+		TEST_KEYFRAME_INTERVAL - 1, TEST_KEYFRAME_INTERVAL, TEST_KEYFRAME_INTERVAL + 1, 5,
+		4 * TEST_KEYFRAME_INTERVAL + 1, 4 * TEST_KEYFRAME_INTERVAL - 1, 4 * TEST_KEYFRAME_INTERVAL,
+		TEST_TICKS, 0, 900, 1150, TEST_TICKS - 1
+	}){
+		player.seek(target);
+		CHECK_EQUAL(player.get_tick(), target);
+		CHECK_EQUAL(player.get_state_hash(), state_hashes[target]);
+	}
+	CHECK_EQUAL(player.get_desync_tick(), -1);
+}
+
+// A replay of a game that went its own way reports the first tick whose hash disagrees
+static void test_desync(const string& filename){
+	const int desync_tick = 600;
+	record(filename, desync_tick);
+
+	ReplayPlayer player(filename.c_str());
+	CHECK(player.is_open());
+	player.seek(0);
+	while(player.get_desync_tick() < 0 && player.step());
+	CHECK_EQUAL(player.get_desync_tick(), desync_tick + 1);
+}
+
+// Writes the recorded file with one value overwritten at the given offset
+template<typename T>
+static void write_patched(const string& filename, string data, size_t offset, T value){
+	stringstream patch;
+	serialize_value(patch, value);
+	data.replace(offset, patch.str().size(), patch.str());
+	ofstream(filename, ios::out | ios::binary).write(data.data(), data.size());
+}
+
+template<typename T>
+static T read_at(const string& data, size_t offset){
+	stringstream input(data.substr(offset));
+	return deserialize_value<T>(input);
+}
+
+// Offsets and lengths that point past their data fail the load instead of reading outside the file
+static void test_corrupt(const string& filename){
+	record(filename);
+	string data;
+	{
+		ifstream input(filename, ios::in | ios::binary);
+		data.assign(istreambuf_iterator<char>(input), istreambuf_iterator<char>());
+	}
+
+	// The footer holds the index offset, the tick count and the magic
+	auto index_offset = read_at<unsigned long long>(data, data.size() - 8 - 4 - 4);
+	// The index holds its length, then the tick and the offset of every keyframe
+	auto keyframe_entry = [&](int i){ return (size_t)index_offset + 4 + i * (4 + 8) + 4; };
+	auto keyframe_offset = [&](int i){ return (size_t)read_at<unsigned long long>(data, keyframe_entry(i)); };
+
+	write_patched(filename, data, keyframe_entry(0), index_offset);
+	CHECK(!ReplayPlayer(filename.c_str()).is_open());
+
+	// The snapshot length follows the record type and the tick
+	write_patched(filename, data, keyframe_offset(0) + 1 + 4, (unsigned int)data.size());
+	CHECK(!ReplayPlayer(filename.c_str()).is_open());
+
+	// A broken later keyframe leaves the player where it was
+	write_patched(filename, data, keyframe_offset(2) + 1 + 4, (unsigned int)data.size());
+	ReplayPlayer player(filename.c_str());
+	CHECK(player.is_open());
+	player.seek(2 * TEST_KEYFRAME_INTERVAL);
+	CHECK_EQUAL(player.get_tick(), 0);
+}
+
+// Arguments: [replay file, next to the executable by default]
+int main(int argc, char** argv){
+	string filename = argc > 1 ? argv[1] : string(argv[0]) + ".ttr";
+
+	test_playback(filename);
+	test_desync(filename);
+	test_corrupt(filename);
+
+	remove(filename.c_str());
+	return test_result("replay_test");
+}
@@ -0,0 +1,99 @@
+#include <map>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include "test.h"
+
+#include "../utils/slot_map.h"
+#include "../utils/serialization.h"
+
+using namespace std;
+
+#define TEST_SEED 2024
+#define TEST_OPERATIONS 20000
+#define TEST_MAX_SIZE 64
+
+// Round entities used to live in a map keyed by an increasing id.
+// A slot map fed the same seeded inserts and erases must hold the same values under the same handles.
+static bool same_values(const SlotMap<int>& slot_map, const map<int, int>& reference, const map<int, int>& handles){
+	if(slot_map.size() != reference.size()) return false;
+	for(const auto& [id, value]: reference){
+		const int* found = slot_map.get(handles.at(id));
+		if(found == nullptr || *found != value) return false;
+	}
+	int visited = 0;
+	for(const auto& entry: slot_map) visited += slot_map.get(entry.first) == &entry.second;
+	return visited == reference.size();
+}
+
+static void test_operations(){
+	mt19937 random(TEST_SEED);
+	SlotMap<int> slot_map;
+	map<int, int> reference;  // Creation id -> value
+	map<int, int> handles;  // Creation id -> slot map handle
+	int next_id = 0;
+
+	int mismatches = 0, stale_handles = 0;
+	for(int operation = 0; operation < TEST_OPERATIONS; operation++){
+		bool erase = !reference.empty() && (reference.size() >= TEST_MAX_SIZE || random() % 2 == 0);
+		if(erase){
+			auto entry = reference.begin();
+			advance(entry, random() % reference.size());
+			int handle = handles[entry->first];
+			CHECK(slot_map.erase(handle));
+			stale_handles += slot_map.contains(handle) || slot_map.erase(handle);
+			handles.erase(entry->first);
+			reference.erase(entry);
+		}
+		else{
+			int value = random();
+			reference[next_id] = value;
+			handles[next_id] = slot_map.insert(move(value));
+			next_id++;
+		}
+
+		mismatches += !same_values(slot_map, reference, handles);
+	}
+	CHECK_EQUAL(mismatches, 0);
+	CHECK_EQUAL(stale_handles, 0);
+}
+
+// Slot indices must not spill into the generation bits
+static void test_full(){
+	SlotMap<int> slot_map;
+	for(int i = 0; i <= SLOT_INDEX_MASK; i++) CHECK(slot_map.insert(int(i)) >= 0);
+	CHECK_EQUAL(slot_map.insert(-1), -1);
+	CHECK_EQUAL(slot_map.size(), SLOT_INDEX_MASK + 1);
+
+	CHECK(slot_map.erase(0));
+	int handle = slot_map.insert(-1);
+	CHECK(handle >= 0 && *slot_map.get(handle) == -1);
+	CHECK(!slot_map.contains(0));
+}
+
+// A loaded map keeps the order and hands out the same handles as the saved one
+static void test_load(){
+	SlotMap<int> slot_map;
+	vector<int> handles;
+	for(int i = 0; i < TEST_MAX_SIZE; i++) handles.push_back(slot_map.insert(int(i)));
+	for(int i = 0; i < TEST_MAX_SIZE; i += 3) slot_map.erase(handles[i]);
+
+	stringstream stream;
+	slot_map.serialize(stream, [](ostream& output, int value){ serialize_value(output, value); });
+	SlotMap<int> loaded;
+	loaded.load(stream, [](istream& input){ return deserialize_value<int>(input); });
+
+	vector<pair<int, int>> saved_entries, loaded_entries;
+	for(const auto& entry: slot_map) saved_entries.push_back({ entry.first, entry.second });
+	for(const auto& entry: loaded) loaded_entries.push_back({ entry.first, entry.second });
+	CHECK(saved_entries == loaded_entries);
+	CHECK_EQUAL(loaded.insert(-1), slot_map.insert(-1));
+}
+
+int main(){
+	test_operations();
+	test_full();
+	test_load();
+	return test_result("slot_map_test");
+}
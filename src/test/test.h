@@ -0,0 +1,34 @@
+#ifndef _TEST_H
+#define _TEST_H
+
+#include <iostream>
+
+using namespace std;
+
+// Every test executable counts its failed checks and exits with test_result()
+static int test_failures = 0;
+
+#define CHECK(condition) do{ \
+	if(!(condition)){ \
+		cerr << __FILE__ << ":" << __LINE__ << ": failed CHECK(" #condition ")" << endl; \
+		test_failures++; \
+	} \
+}while(0)
+
+#define CHECK_EQUAL(actual, expected) do{ \
+	auto _actual = (actual); \
+	auto _expected = (expected); \
+	if(!(_actual == _expected)){ \
+		cerr << __FILE__ << ":" << __LINE__ << ": failed CHECK_EQUAL(" #actual ", " #expected "): " \
+			<< _actual << " != " << _expected << endl; \
+		test_failures++; \
+	} \
+}while(0)
+
+inline int test_result(const char* name){
+	if(test_failures) cerr << name << ": " << test_failures << " check(s) failed" << endl;
+	else cerr << name << ": passed" << endl;
+	return test_failures ? 1 : 0;
+}
+
+#endif
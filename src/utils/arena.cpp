@@ -0,0 +1,68 @@
+#include "arena.h"
+
+#define ARENA_BLOCK_SIZE (64 * 1024)
+#define ARENA_ALIGNMENT 16
+#define ARENA_SIZE_CLASSES 32  // Sizes up to ARENA_ALIGNMENT * ARENA_SIZE_CLASSES are recycled
+
+static inline size_t get_size_class(size_t size){
+	return (size + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT;
+}
+
+Arena::Arena() :
+	current(nullptr),
+	remaining(0),
+	free_lists(ARENA_SIZE_CLASSES + 1, nullptr),
+	stats({
+		.reserved_bytes = 0,
+		.live_bytes = 0,
+		.peak_live_bytes = 0,
+		.allocations = 0,
+		.reused_allocations = 0
+	}) {
+
+}
+
+void* Arena::allocate(size_t size){
+	size_t size_class = get_size_class(size);
+	size = size_class * ARENA_ALIGNMENT;
+
+	stats.allocations++;
+	stats.live_bytes += size;
+	if(stats.live_bytes > stats.peak_live_bytes) stats.peak_live_bytes = stats.live_bytes;
+
+	if(size_class <= ARENA_SIZE_CLASSES && free_lists[size_class] != nullptr){
+		void* memory = free_lists[size_class];
+		free_lists[size_class] = *(void**)memory;
+		stats.reused_allocations++;
+		return memory;
+	}
+
+	if(size > remaining){
+		size_t block_size = size > ARENA_BLOCK_SIZE ? size : ARENA_BLOCK_SIZE;
+		blocks.push_back(unique_ptr<char[]>(new char[block_size]));
+		stats.reserved_bytes += block_size;
+		if(size > ARENA_BLOCK_SIZE) return blocks.back().get();  // Oversized, keep bumping the current block
+
+		current = blocks.back().get();
+		remaining = block_size;
+	}
+
+	void* memory = current;
+	current += size;
+	remaining -= size;
+	return memory;
+}
+
+void Arena::release(void* memory, size_t size){
+	size_t size_class = get_size_class(size);
+	stats.live_bytes -= size_class * ARENA_ALIGNMENT;
+
+	if(size_class <= ARENA_SIZE_CLASSES){
+		*(void**)memory = free_lists[size_class];
+		free_lists[size_class] = memory;
+	}
+}
+
+const ArenaStats& Arena::get_stats() const{
+	return stats;
+}
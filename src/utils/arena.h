@@ -0,0 +1,75 @@
+#ifndef _ARENA_H
+#define _ARENA_H
+
+#include <memory>
+#include <new>
+#include <vector>
+#include <cstddef>
+
+using namespace std;
+
+struct ArenaStats{
+	size_t reserved_bytes;  // Memory held in blocks
+	size_t live_bytes;  // Memory of objects not yet released
+	size_t peak_live_bytes;
+	size_t allocations;
+	size_t reused_allocations;  // Allocations served from a free list
+};
+
+class Arena;
+
+template<typename T>
+class ArenaDeleter{
+public:
+	Arena* arena;
+	size_t size;
+
+	ArenaDeleter() : arena(nullptr), size(0) {}
+	ArenaDeleter(Arena* arena, size_t size) : arena(arena), size(size) {}
+	template<typename U>
+	ArenaDeleter(const ArenaDeleter<U>& other) : arena(other.arena), size(other.size) {}
+
+	void operator()(T* value) const;
+};
+
+template<typename T>
+using ArenaPtr = unique_ptr<T, ArenaDeleter<T>>;
+
+// Monotonic block allocator. Released memory goes to per size class free lists,
+// so high churn objects of one type keep reusing the same memory.
+// Everything is given back at once when the arena is destroyed.
+class Arena{
+	vector<unique_ptr<char[]>> blocks;
+	char* current;
+	size_t remaining;
+
+	vector<void*> free_lists;
+
+	ArenaStats stats;
+public:
+	Arena();
+
+	Arena(const Arena&) = delete;
+	Arena(Arena&&) = delete;
+	Arena& operator=(const Arena&) = delete;
+	Arena& operator=(Arena&&) = delete;
+
+	void* allocate(size_t size);
+	void release(void* memory, size_t size);
+
+	template<typename T, typename... Args>
+	ArenaPtr<T> create(Args&&... args){
+		T* value = new (allocate(sizeof(T))) T(forward<Args>(args)...);
+		return ArenaPtr<T>(value, ArenaDeleter<T>(this, sizeof(T)));
+	}
+
+	const ArenaStats& get_stats() const;
+};
+
+template<typename T>
+void ArenaDeleter<T>::operator()(T* value) const{
+	value->~T();
+	arena->release(value, size);
+}
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef _FIXED_VECTOR_H
+#define _FIXED_VECTOR_H
+
+#include <new>
+#include <initializer_list>
+#include <type_traits>
+
+#include "span.h"
+
+using namespace std;
+
+// Vector with inline storage for at most N values, never allocates
+template<typename T, int N>
+class FixedVector{
+	static_assert(is_trivially_copyable<T>::value, "FixedVector only holds trivially copyable values");
+
+	alignas(T) unsigned char storage[N * sizeof(T)];
+	int length;
+
+	T* values(){ return reinterpret_cast<T*>(storage); }
+	const T* values() const{ return reinterpret_cast<const T*>(storage); }
+public:
+	FixedVector() : length(0) {}
+	FixedVector(initializer_list<T> init) : length(0) {
+		for(const auto& value: init) push_back(value);
+	}
+
+	T* begin(){ return values(); }
+	T* end(){ return values() + length; }
+	const T* begin() const{ return values(); }
+	const T* end() const{ return values() + length; }
+
+	int size() const{ return length; }
+	bool empty() const{ return length == 0; }
+
+	T& operator[](int index){ return values()[index]; }
+	const T& operator[](int index) const{ return values()[index]; }
+	T& back(){ return values()[length - 1]; }
+	const T& back() const{ return values()[length - 1]; }
+
+	void push_back(const T& value){
+		new (values() + length) T(value);
+		length++;
+	}
+	void insert(int index, const T& value){
+		for(int i = length; i > index; i--) new (values() + i) T(values()[i - 1]);
+		new (values() + index) T(value);
+		length++;
+	}
+	void pop_back(){
+		length--;
+	}
+	void clear(){
+		length = 0;
+	}
+
+	operator Span<T>() const{
+		return Span<T>(values(), length);
+	}
+};
+
+// Double ended queue over a ring of N inline slots, never allocates
+template<typename T, int N>
+class FixedDeque{
+	static_assert(is_trivially_copyable<T>::value, "FixedDeque only holds trivially copyable values");
+
+	alignas(T) unsigned char storage[N * sizeof(T)];
+	int start, length;
+
+	T* slot(int index){ return reinterpret_cast<T*>(storage) + (start + index) % N; }
+	const T* slot(int index) const{ return reinterpret_cast<const T*>(storage) + (start + index) % N; }
+public:
+	FixedDeque() : start(0), length(0) {}
+
+	int size() const{ return length; }
+	bool empty() const{ return length == 0; }
+
+	const T& operator[](int index) const{ return *slot(index); }
+	const T& front() const{ return *slot(0); }
+	const T& back() const{ return *slot(length - 1); }
+
+	void push_back(const T& value){
+		new (slot(length)) T(value);
+		length++;
+	}
+	void push_front(const T& value){
+		start = (start + N - 1) % N;
+		new (slot(0)) T(value);
+		length++;
+	}
+	void pop_back(){
+		length--;
+	}
+	void pop_front(){
+		start = (start + 1) % N;
+		length--;
+	}
+};
+
+#endif
@@ -0,0 +1,82 @@
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const char* filename) :
+	data(nullptr),
+	size(0),
+	file(INVALID_HANDLE_VALUE),
+	mapping(NULL) {
+
+	file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(file == INVALID_HANDLE_VALUE) return;
+
+	LARGE_INTEGER file_size;
+	if(!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) return;
+
+	mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if(mapping == NULL) return;
+
+	data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if(data != nullptr) size = file_size.QuadPart;
+}
+
+MappedFile::~MappedFile(){
+	if(data != nullptr) UnmapViewOfFile(data);
+	if(mapping != NULL) CloseHandle(mapping);
+	if(file != INVALID_HANDLE_VALUE) CloseHandle(file);
+}
+
+#else
+
+MappedFile::MappedFile(const char* filename) :
+	data(nullptr),
+	size(0),
+	file(-1) {
+
+	file = open(filename, O_RDONLY);
+	if(file < 0) return;
+
+	struct stat file_stat;
+	if(fstat(file, &file_stat) < 0 || file_stat.st_size == 0) return;
+
+	void* mapping = mmap(NULL, file_stat.st_size, PROT_READ, MAP_SHARED, file, 0);
+	if(mapping == MAP_FAILED) return;
+
+	data = (const char*)mapping;
+	size = file_stat.st_size;
+}
+
+MappedFile::~MappedFile(){
+	if(data != nullptr) munmap((void*)data, size);
+	if(file >= 0) close(file);
+}
+
+#endif
+
+bool MappedFile::is_open() const{
+	return data != nullptr;
+}
+const char* MappedFile::get_data() const{
+	return data;
+}
+size_t MappedFile::get_size() const{
+	return size;
+}
+
+MemoryBuffer::MemoryBuffer(const char* begin, const char* end){
+	setg((char*)begin, (char*)begin, (char*)end);
+}
+
+size_t MemoryBuffer::get_position() const{
+	return gptr() - eback();
+}
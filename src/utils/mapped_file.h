@@ -0,0 +1,42 @@
+#ifndef _MAPPED_FILE_H
+#define _MAPPED_FILE_H
+
+#include <streambuf>
+#include <cstddef>
+
+using namespace std;
+
+// Read only memory mapping of a whole file
+class MappedFile{
+	const char* data;
+	size_t size;
+#ifdef _WIN32
+	void* file;
+	void* mapping;
+#else
+	int file;
+#endif
+public:
+	MappedFile(const char* filename);
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile(MappedFile&&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile& operator=(MappedFile&&) = delete;
+
+	~MappedFile();
+
+	bool is_open() const;
+	const char* get_data() const;
+	size_t get_size() const;
+};
+
+// Stream buffer reading directly from a memory range, to be used with istream
+class MemoryBuffer : public streambuf{
+public:
+	MemoryBuffer(const char* begin, const char* end);
+
+	size_t get_position() const;
+};
+
+#endif
@@ -205,6 +205,19 @@ Point Point::deserialize(istream& input){
 	};
 }
 
+void TimePoint::serialize(ostream& output) const{
+	serialize_value(output, point);
+	serialize_value(output, time);
+}
+TimePoint TimePoint::deserialize(istream& input){
+	auto point = deserialize_value<Point>(input);
+	auto time = deserialize_value<Number>(input);
+	return {
+		.point = point,
+		.time = time
+	};
+}
+
 Point Point::operator +(const Point& other) const{
 	return {
 		.x = x + other.x,
@@ -3,6 +3,8 @@
 
 #include <iostream>
 
+#include "state_hash.h"
+
 using namespace std;
 
 class Number;
@@ -32,6 +34,8 @@ class Number{
 	friend Number operator-(double num1, Number num2);
 	friend Number operator*(double num1, Number num2);
 	friend Number operator/(double num1, Number num2);
+
+	friend struct Point;
 public:
 	Number(int value);
 	Number(double value);
@@ -89,6 +93,9 @@ public:
 	
 	void serialize(ostream& output) const;
 	static Number deserialize(istream& input);
+	void hash(StateHash& hash) const{
+		hash.add(scaled_value);
+	}
 	
 	static Number random(Number min, Number max);
 };
@@ -119,12 +126,19 @@ struct Point{
 
 	void serialize(ostream& output) const;
 	static Point deserialize(istream& input);
+	// Both coordinates in one word, positions are hashed for every object every tick
+	void hash(StateHash& hash) const{
+		hash.add(x.scaled_value, y.scaled_value);
+	}
 };
 
 
 struct TimePoint{
 	Point point;
 	Number time;
+
+	void serialize(ostream& output) const;
+	static TimePoint deserialize(istream& input);
 };
 
 #endif
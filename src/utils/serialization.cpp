@@ -13,12 +13,12 @@ void serialize_flags(
 ){
 	unsigned char mask = 0;
 	if(flag1) mask |= 1 << 0;
-	if(flag1) mask |= 1 << 1;
-	if(flag1) mask |= 1 << 2;
-	if(flag1) mask |= 1 << 3;
-	if(flag1) mask |= 1 << 4;
-	if(flag1) mask |= 1 << 5;
-	if(flag1) mask |= 1 << 6;
-	if(flag1) mask |= 1 << 7;
+	if(flag2) mask |= 1 << 1;
+	if(flag3) mask |= 1 << 2;
+	if(flag4) mask |= 1 << 3;
+	if(flag5) mask |= 1 << 4;
+	if(flag6) mask |= 1 << 5;
+	if(flag7) mask |= 1 << 6;
+	if(flag8) mask |= 1 << 7;
 	serialize_value(output, mask);
 }
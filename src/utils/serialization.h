@@ -5,6 +5,7 @@
 #include <ostream>
 #include <istream>
 #include <vector>
+#include <set>
 #include <array>
 
 using namespace std;
@@ -45,9 +46,9 @@ T deserialize_int(istream& input){
 	char data[size];
 	input.read(data, size);
 	
-	T result;
+	T result = 0;
 	for(unsigned int i = 0; i < size; i++){
-		result |= data[i] << (i << 3);
+		result |= (T)(unsigned char)data[i] << (i << 3);
 	}
 	return result;
 }
@@ -66,6 +67,18 @@ public:
 	unsigned static int deserialize(istream& input) { return deserialize_int<unsigned int, 4>(input); }
 };
 template<>
+class Serializer<long long>{
+public:
+	static void serialize(ostream& output, long long value) { serialize_int<long long, 8>(output, value); }
+	static long long deserialize(istream& input) { return deserialize_int<long long, 8>(input); }
+};
+template<>
+class Serializer<unsigned long long>{
+public:
+	static void serialize(ostream& output, unsigned long long value) { serialize_int<unsigned long long, 8>(output, value); }
+	unsigned static long long deserialize(istream& input) { return deserialize_int<unsigned long long, 8>(input); }
+};
+template<>
 class Serializer<char>{
 public:
 	static void serialize(ostream& output, char value) { serialize_int<char, 1>(output, value); }
@@ -108,6 +121,30 @@ public:
 	}
 };
 
+template<typename T>
+class Serializer<set<T>>{
+public:
+	static void serialize(ostream& output, const set<T>& value){
+		unsigned int length = value.size();
+		serialize_value(output, length);
+		
+		for(const T& element: value){
+			serialize_value(output, element);
+		}
+	}
+
+	static set<T> deserialize(istream& input){
+		set<T> result;
+		
+		auto size  = deserialize_value<unsigned int>(input);
+		for(unsigned int i = 0; i < size; i++){
+			result.insert(deserialize_value<T>(input));
+		}
+		
+		return result;
+	}
+};
+
 template<>
 class Serializer<string>{
 public:
@@ -0,0 +1,145 @@
+#ifndef _SLOT_MAP_H
+#define _SLOT_MAP_H
+
+#include "serialization.h"
+
+#include <vector>
+#include <utility>
+#include <iostream>
+
+using namespace std;
+
+#define SLOT_INDEX_BITS 16
+#define SLOT_INDEX_MASK ((1 << SLOT_INDEX_BITS) - 1)
+#define SLOT_GENERATION_MASK 0x7fff
+
+// Dense storage addressed by generational handles.
+// A handle packs the slot index in the low bits and the slot generation above it,
+// so handles of removed values never resolve to a newer value in the same slot.
+// Removal moves the last value into the hole, so the iteration order depends on the order of removals.
+// That order is still the same on every peer and after a load.
+template<typename T>
+class SlotMap{
+	vector<T> values;
+	vector<int> handles;  // Handle of every dense value
+
+	vector<int> slot_indices;  // Dense index of every slot, -1 when free
+	vector<int> slot_generations;
+	vector<int> free_slots;
+
+	int find(int handle) const{
+		if(handle < 0) return -1;
+		int slot = handle & SLOT_INDEX_MASK;
+		if(slot >= slot_indices.size()) return -1;
+		if(slot_generations[slot] != (handle >> SLOT_INDEX_BITS)) return -1;
+		return slot_indices[slot];
+	}
+public:
+	class Iterator{
+		const SlotMap* slot_map;
+		int index;
+	public:
+		Iterator(const SlotMap* slot_map, int index) : slot_map(slot_map), index(index) {}
+
+		pair<int, const T&> operator*() const{
+			return { slot_map->handles[index], slot_map->values[index] };
+		}
+		Iterator& operator++(){
+			index++;
+			return *this;
+		}
+		bool operator!=(const Iterator& other) const{
+			return index != other.index;
+		}
+	};
+
+	// Returns -1, which never resolves, when every slot index is taken
+	int insert(T&& value){
+		int slot;
+		if(free_slots.empty()){
+			if(slot_indices.size() > SLOT_INDEX_MASK) return -1;
+			slot = slot_indices.size();
+			slot_indices.push_back(-1);
+			slot_generations.push_back(0);
+		}
+		else{
+			slot = free_slots.back();
+			free_slots.pop_back();
+		}
+
+		int handle = slot | (slot_generations[slot] << SLOT_INDEX_BITS);
+		slot_indices[slot] = values.size();
+		values.push_back(move(value));
+		handles.push_back(handle);
+		return handle;
+	}
+
+	bool erase(int handle){
+		int index = find(handle);
+		if(index < 0) return false;
+
+		int slot = handle & SLOT_INDEX_MASK;
+		slot_indices[slot] = -1;
+		slot_generations[slot] = (slot_generations[slot] + 1) & SLOT_GENERATION_MASK;
+		free_slots.push_back(slot);
+
+		int last = values.size() - 1;
+		if(index != last){
+			values[index] = move(values[last]);
+			handles[index] = handles[last];
+			slot_indices[handles[index] & SLOT_INDEX_MASK] = index;
+		}
+		values.pop_back();
+		handles.pop_back();
+		return true;
+	}
+
+	bool contains(int handle) const{
+		return find(handle) >= 0;
+	}
+
+	T* get(int handle){
+		int index = find(handle);
+		return index < 0 ? nullptr : &values[index];
+	}
+	const T* get(int handle) const{
+		int index = find(handle);
+		return index < 0 ? nullptr : &values[index];
+	}
+
+	int size() const{
+		return values.size();
+	}
+	bool empty() const{
+		return values.empty();
+	}
+
+	Iterator begin() const{
+		return Iterator(this, 0);
+	}
+	Iterator end() const{
+		return Iterator(this, values.size());
+	}
+
+	// The layout is part of the state, so that a loaded map hands out the same handles in the same order
+	template<typename F>
+	void serialize(ostream& output, F serialize_item) const{
+		serialize_value(output, handles);
+		serialize_value(output, slot_indices);
+		serialize_value(output, slot_generations);
+		serialize_value(output, free_slots);
+		for(const auto& value: values) serialize_item(output, value);
+	}
+	template<typename F>
+	void load(istream& input, F deserialize_item){
+		handles = deserialize_value<vector<int>>(input);
+		slot_indices = deserialize_value<vector<int>>(input);
+		slot_generations = deserialize_value<vector<int>>(input);
+		free_slots = deserialize_value<vector<int>>(input);
+
+		values.clear();
+		for(int i = 0; i < handles.size(); i++) values.push_back(deserialize_item(input));
+	}
+};
+
+#endif
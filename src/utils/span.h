@@ -0,0 +1,28 @@
+#ifndef _SPAN_H
+#define _SPAN_H
+
+#include <vector>
+
+using namespace std;
+
+// Read only view of contiguous storage owned by someone else
+template<typename T>
+class Span{
+	const T* data;
+	int length;
+public:
+	Span() : data(nullptr), length(0) {}
+	Span(const T* data, int length) : data(data), length(length) {}
+	Span(const vector<T>& values) : data(values.data()), length(values.size()) {}
+
+	const T* begin() const { return data; }
+	const T* end() const { return data + length; }
+
+	int size() const { return length; }
+	bool empty() const { return length == 0; }
+
+	const T& operator[](int index) const { return data[index]; }
+	const T& back() const { return data[length - 1]; }
+};
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef _STATE_HASH_H
+#define _STATE_HASH_H
+
+#include <cstdint>
+#include <type_traits>
+
+using namespace std;
+
+// Order dependent 64 bit hash of integer words, cheap enough to cover the whole simulation every tick:
+// a single multiply per word, with the avalanche left to get().
+// Only integers and enums are accepted, so fixed point numbers are hashed by their scaled value
+// instead of being converted implicitly.
+class StateHash{
+	uint64_t value;
+
+	void mix(uint64_t word){
+		value = ((value << 5 | value >> 59) ^ word) * 0x517cc1b727220a95ULL;
+	}
+public:
+	StateHash(uint64_t seed = 0) : value(seed ^ 0x9e3779b97f4a7c15ULL) {}
+
+	template<typename T>
+	void add(T word){
+		static_assert(is_integral<T>::value || is_enum<T>::value, "only integer words can be hashed");
+		mix((uint64_t)word);
+	}
+	// Packs two words of up to 32 bits into one, halving the multiplies for small fields
+	template<typename T, typename U>
+	void add(T low, U high){
+		static_assert(is_integral<T>::value || is_enum<T>::value, "only integer words can be hashed");
+		static_assert(is_integral<U>::value || is_enum<U>::value, "only integer words can be hashed");
+		static_assert(sizeof(T) <= 4 && sizeof(U) <= 4, "only words of up to 32 bits can be packed");
+		mix((uint64_t)(uint32_t)low | (uint64_t)(uint32_t)high << 32);
+	}
+
+	uint64_t get() const{
+		uint64_t result = value;
+		result = (result ^ (result >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		result = (result ^ (result >> 27)) * 0x94d049bb133111ebULL;
+		return result ^ (result >> 31);
+	}
+};
+
+template<typename T>
+uint64_t get_state_hash(const T& value){
+	StateHash hash;
+	value.hash(hash);
+	return hash.get();
+}
+
+#endif
@@ -0,0 +1,107 @@
+#include "trace.h"
+
+#ifdef TRACING
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <fstream>
+#include <iomanip>
+
+static const chrono::steady_clock::time_point trace_epoch = chrono::steady_clock::now();
+static atomic<bool> tracing_enabled(false);
+
+static mutex buffers_mutex;
+static vector<unique_ptr<TraceBuffer>> buffers;
+static thread_local TraceBuffer* thread_buffer = nullptr;
+
+TraceBuffer::TraceBuffer(int thread_id) :
+	written(0),
+	thread_id(thread_id),
+	thread_name(nullptr) {}
+
+void TraceBuffer::record(const char* name, char phase){
+	uint64_t index = written.load(memory_order_relaxed);
+	events[index % TRACE_BUFFER_SIZE] = {
+		.name = name,
+		.time = (uint64_t)chrono::duration_cast<chrono::nanoseconds>(
+			chrono::steady_clock::now() - trace_epoch
+		).count(),
+		.phase = phase
+	};
+	written.store(index + 1, memory_order_release);
+}
+
+int TraceBuffer::read(TraceEvent* output) const{
+	uint64_t end = written.load(memory_order_acquire);
+	uint64_t start = end > TRACE_BUFFER_SIZE ? end - TRACE_BUFFER_SIZE : 0;
+	for(uint64_t index = start; index < end; index++){
+		output[index - start] = events[index % TRACE_BUFFER_SIZE];
+	}
+	return end - start;
+}
+
+void enable_tracing(bool enabled){
+	tracing_enabled.store(enabled, memory_order_relaxed);
+}
+bool is_tracing_enabled(){
+	return tracing_enabled.load(memory_order_relaxed);
+}
+
+TraceBuffer& get_thread_trace_buffer(){
+	if(thread_buffer == nullptr){
+		lock_guard<mutex> lock(buffers_mutex);
+		buffers.push_back(make_unique<TraceBuffer>(buffers.size() + 1));
+		thread_buffer = buffers.back().get();
+	}
+	return *thread_buffer;
+}
+
+void set_trace_thread_name(const char* name){
+	get_thread_trace_buffer().thread_name.store(name, memory_order_relaxed);
+}
+
+void trace_begin(const char* name){
+	if(!tracing_enabled.load(memory_order_relaxed)) return;
+	get_thread_trace_buffer().record(name, 'B');
+}
+void trace_end(const char* name){
+	if(!tracing_enabled.load(memory_order_relaxed)) return;
+	get_thread_trace_buffer().record(name, 'E');
+}
+
+bool write_trace(const char* path){
+	ofstream output(path);
+	if(!output.is_open()) return false;
+
+	output << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+	bool first = true;
+
+	vector<TraceEvent> events(TRACE_BUFFER_SIZE);
+	lock_guard<mutex> lock(buffers_mutex);
+	for(const auto& buffer: buffers){
+		const char* thread_name = buffer->thread_name.load(memory_order_relaxed);
+		if(thread_name != nullptr){
+			output << (first ? "" : ",") << endl
+				<< "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->thread_id
+				<< ",\"args\":{\"name\":\"" << thread_name << "\"}}";
+			first = false;
+		}
+
+		int count = buffer->read(events.data());
+		for(int i = 0; i < count; i++){
+			output << (first ? "" : ",") << endl
+				<< "{\"name\":\"" << events[i].name
+				<< "\",\"ph\":\"" << events[i].phase
+				<< "\",\"ts\":" << fixed << setprecision(3) << events[i].time / 1000.0
+				<< ",\"pid\":1,\"tid\":" << buffer->thread_id << "}";
+			first = false;
+		}
+	}
+	output << endl << "]}" << endl;
+
+	return output.good();
+}
+
+#endif
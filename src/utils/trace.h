@@ -0,0 +1,74 @@
+#ifndef _TRACE_H
+#define _TRACE_H
+
+// Timeline of begin/end events exported in the Chrome trace format (chrome://tracing, Perfetto),
+// only compiled in with -DTRACING
+
+#ifdef TRACING
+
+#include <atomic>
+#include <cstdint>
+
+using namespace std;
+
+#define TRACE_BUFFER_SIZE (1 << 16)
+
+struct TraceEvent{
+	const char* name;  // String literal, only the pointer is stored
+	uint64_t time;  // Nanoseconds since the trace epoch
+	char phase;  // 'B' or 'E'
+};
+
+// Ring of the latest events of one thread, only that thread writes to it
+class TraceBuffer{
+	TraceEvent events[TRACE_BUFFER_SIZE];
+	atomic<uint64_t> written;
+public:
+	const int thread_id;
+	atomic<const char*> thread_name;
+
+	TraceBuffer(int thread_id);
+
+	void record(const char* name, char phase);
+
+	// Copies out the retained events, oldest first, returns their count
+	int read(TraceEvent* output) const;
+};
+
+void enable_tracing(bool enabled);
+bool is_tracing_enabled();
+
+TraceBuffer& get_thread_trace_buffer();
+void set_trace_thread_name(const char* name);
+
+void trace_begin(const char* name);
+void trace_end(const char* name);
+
+class TraceScope{
+	const char* name;
+public:
+	TraceScope(const char* name) : name(name) { trace_begin(name); }
+	~TraceScope(){ trace_end(name); }
+};
+
+// Writes every thread's retained events as Chrome trace JSON, best called once the traced threads are idle
+bool write_trace(const char* path);
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(trace_scope_, __LINE__)(name)
+#define TRACE_BEGIN(name) trace_begin(name)
+#define TRACE_END(name) trace_end(name)
+#define TRACE_THREAD_NAME(name) set_trace_thread_name(name)
+
+#else
+
+#define TRACE_SCOPE(name)
+#define TRACE_BEGIN(name)
+#define TRACE_END(name)
+#define TRACE_THREAD_NAME(name)
+
+#endif
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef _TRIPLE_BUFFER_H
+#define _TRIPLE_BUFFER_H
+
+#include <atomic>
+
+using namespace std;
+
+// Lock free single producer single consumer handoff of the latest complete value
+template<typename T>
+class TripleBuffer{
+	static const int INDEX_MASK = 3;
+	static const int FRESH = 4;
+
+	T buffers[3];
+	atomic<int> shared;
+	int back, front;
+public:
+	TripleBuffer() : shared(1), back(0), front(2) {}
+
+	TripleBuffer(const TripleBuffer&) = delete;
+	TripleBuffer(TripleBuffer&&) = delete;
+	TripleBuffer& operator=(const TripleBuffer&) = delete;
+	TripleBuffer& operator=(TripleBuffer&&) = delete;
+
+	// Producer side
+	T& get_back(){
+		return buffers[back];
+	}
+	void publish(){
+		back = shared.exchange(back | FRESH, memory_order_acq_rel) & INDEX_MASK;
+	}
+
+	// Consumer side, returns whether a newer value became the front
+	bool update(){
+		if(!(shared.load(memory_order_relaxed) & FRESH)) return false;
+		front = shared.exchange(front, memory_order_acq_rel) & INDEX_MASK;
+		return true;
+	}
+	const T& get_front() const{
+		return buffers[front];
+	}
+};
+
+#endif
@@ -1,11 +1,39 @@
 #include "utils.h"
+#include "serialization.h"
+#include "state_hash.h"
+
 #include <random>
 #include <chrono>
+#include <sstream>
 
 using namespace std;
 using namespace std::chrono;
 
+static default_random_engine shared_engine(system_clock::now().time_since_epoch().count());
+static thread_local default_random_engine* current_engine = &shared_engine;
+
 int rand_range(int min, int max){
-	static default_random_engine engine(system_clock::now().time_since_epoch().count());
-	return uniform_int_distribution<int>(min, max - 1)(engine);
+	return uniform_int_distribution<int>(min, max - 1)(*current_engine);
+}
+
+void seed_random(unsigned int seed){
+	current_engine->seed(seed);
+}
+
+void serialize_random_state(ostream& output){
+	stringstream state;
+	state << *current_engine;
+	serialize_value(output, state.str());
+}
+void deserialize_random_state(istream& input){
+	stringstream state(deserialize_value<string>(input));
+	state >> *current_engine;
+}
+void hash_random_state(StateHash& hash){
+	// The next draw of a copy stands in for the engine state
+	auto copy = *current_engine;
+	hash.add(copy());
+}
+void use_random_engine(default_random_engine* engine){
+	current_engine = engine != nullptr ? engine : &shared_engine;
 }
@@ -3,11 +3,23 @@
 
 #include <vector>
 #include <algorithm>
+#include <iostream>
+#include <random>
 
 using namespace std;
 
+class StateHash;
+
 int rand_range(int min, int max);
 
+void seed_random(unsigned int seed);
+void serialize_random_state(ostream& output);
+void deserialize_random_state(istream& input);
+void hash_random_state(StateHash& hash);
+// Makes the calling thread draw from the given engine instead of the shared one, until called with nullptr,
+// so games stepped on several threads keep separate streams
+void use_random_engine(default_random_engine* engine);
+
 template<typename T>
 void remove_index(vector<T>& container, int index){
 	container.erase(container.begin() + index);